@@ -0,0 +1,440 @@
+//
+//  main.cpp
+//  Benchmark
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+//  Measures vision stages on synthetic or recorded camera frames.
+//
+//  usage: benchmark [-n <numberOfFrames>] [-t] [-r <recording> <width>x<height> <rgb|bgra|nv12|i420|rggb|bggr>]
+//      -n  number of measured frames per scenario, 200 by default
+//      -t  labels blobs with tracking, see `BrainWorker::setBlobTracking`
+//      -r  replays raw frames recorded back to back instead of synthetic scenarios
+//
+//  Synthetic scenarios cover resolutions from 640x480 to 3840x2160 in every supported color space. Frames contain
+//  1 to 5 red, green and blue blobs of varying size on a noisy gray background.
+//  Every stage reports latency percentiles in ms and allocations per frame, vision is the whole
+//  `BrainWorker::processVisualInput` of both eyes.
+//
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <opencv2/opencv.hpp>
+#include "../Brain-Framework/BrainWorker.hpp"
+#include "../Brain-Framework/Vision/Eye.hpp"
+
+// MARK: - Allocation counting
+
+/// Counts every allocation of the process. Buffers of `cv::Mat` are counted as well, since OpenCV allocates
+/// their reference counting data with `new`.
+static std::atomic<long long> numberOfAllocations { 0 };
+
+void * operator new(size_t size)
+{
+    numberOfAllocations++;
+    void *pointer = malloc(size == 0 ? 1 : size);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void * operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+// MARK: - Stages
+
+static const int numberOfWarmUpFrames = 10;
+static const int numberOfSyntheticFrames = 16;
+
+struct Stage {
+    std::string name;
+    std::vector<double> durations;
+    long long allocations = 0;
+    
+    explicit Stage(const std::string &name_) : name(name_) {}
+};
+
+template <typename Function>
+static void measure(Stage &stage, bool recorded, Function function)
+{
+    long long allocations = numberOfAllocations;
+    auto start = std::chrono::steady_clock::now();
+    function();
+    double duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    // Warm up frames allocate buffers which are reused later, so they aren't recorded
+    if (recorded) {
+        stage.durations.push_back(duration);
+        stage.allocations += numberOfAllocations - allocations;
+    }
+}
+
+static double percentile(const std::vector<double> &sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = std::min(sorted.size() - 1, (size_t)(fraction * sorted.size()));
+    return sorted[index];
+}
+
+static void report(const std::string &scenario, std::vector<Stage> &stages)
+{
+    printf("%s\n", scenario.c_str());
+    printf("  %-10s %9s %9s %9s %9s %13s\n", "stage", "p50", "p90", "p99", "max", "allocs/frame");
+    for (Stage &stage : stages) {
+        std::vector<double> sorted = stage.durations;
+        std::sort(sorted.begin(), sorted.end());
+        double allocationsPerFrame = sorted.empty() ? 0 : (double)stage.allocations / sorted.size();
+        printf("  %-10s %9.3f %9.3f %9.3f %9.3f %13.2f\n", stage.name.c_str(),
+               percentile(sorted, 0.5), percentile(sorted, 0.9), percentile(sorted, 0.99),
+               sorted.empty() ? 0 : sorted.back(), allocationsPerFrame);
+    }
+}
+
+// MARK: - Frames
+
+static const char * colorSpaceName(ColorSpace colorSpace)
+{
+    switch (colorSpace) {
+        case ColorSpaceBGRA: return "BGRA";
+        case ColorSpaceNV12: return "NV12";
+        case ColorSpaceI420: return "I420";
+        case ColorSpaceBayerRGGB: return "RGGB";
+        case ColorSpaceBayerBGGR: return "BGGR";
+        default: return "RGB";
+    }
+}
+
+static int parseColorSpace(const std::string &name, ColorSpace &colorSpace)
+{
+    if (name == "rgb") {
+        colorSpace = ColorSpaceRGB;
+    } else if (name == "bgra") {
+        colorSpace = ColorSpaceBGRA;
+    } else if (name == "nv12") {
+        colorSpace = ColorSpaceNV12;
+    } else if (name == "i420") {
+        colorSpace = ColorSpaceI420;
+    } else if (name == "rggb") {
+        colorSpace = ColorSpaceBayerRGGB;
+    } else if (name == "bggr") {
+        colorSpace = ColorSpaceBayerBGGR;
+    } else {
+        return 1;
+    }
+    return 0;
+}
+
+static size_t frameSize(int width, int height, ColorSpace colorSpace)
+{
+    switch (colorSpace) {
+        case ColorSpaceNV12:
+        case ColorSpaceI420:
+            return (size_t)width * height + 2 * (size_t)((width + 1) / 2) * ((height + 1) / 2);
+        case ColorSpaceBGRA:
+            return (size_t)width * height * 4;
+        case ColorSpaceBayerRGGB:
+        case ColorSpaceBayerBGGR:
+            return (size_t)width * height;
+        default:
+            return (size_t)width * height * 3;
+    }
+}
+
+/// Wraps planes of frame the same way as `BrainWorker` does.
+/// @return Number of planes
+static int framePlanes(uint8_t *frame, int width, int height, ColorSpace colorSpace, cv::Mat planes[Eye::maxNumberOfPlanes])
+{
+    int chromaRows = (height + 1) / 2;
+    int chromaCols = (width + 1) / 2;
+    
+    switch (colorSpace) {
+        case ColorSpaceNV12:
+            planes[0] = cv::Mat(height, width, CV_8UC1, frame);
+            planes[1] = cv::Mat(chromaRows, chromaCols, CV_8UC2, frame + width * height);
+            return 2;
+        case ColorSpaceI420:
+            planes[0] = cv::Mat(height, width, CV_8UC1, frame);
+            planes[1] = cv::Mat(chromaRows, chromaCols, CV_8UC1, frame + width * height);
+            planes[2] = cv::Mat(chromaRows, chromaCols, CV_8UC1, frame + width * height + chromaRows * chromaCols);
+            return 3;
+        case ColorSpaceBayerRGGB:
+        case ColorSpaceBayerBGGR:
+            planes[0] = cv::Mat(height / 2, width / 2, CV_8UC2, frame, width * 2);
+            planes[1] = cv::Mat(height / 2, width / 2, CV_8UC2, frame + width, width * 2);
+            return 2;
+        case ColorSpaceBGRA:
+            planes[0] = cv::Mat(height, width, CV_8UC4, frame);
+            return 1;
+        default:
+            planes[0] = cv::Mat(height, width, CV_8UC3, frame);
+            return 1;
+    }
+}
+
+/// Draws blobs of random count, size, color and position on a noisy gray background.
+static std::vector<uint8_t> syntheticFrame(int width, int height, ColorSpace colorSpace, std::mt19937 &gen)
+{
+    cv::Mat rgb(height, width, CV_8UC3, cv::Scalar::all(110));
+    cv::Mat noise(height, width, CV_8UC3);
+    cv::randu(noise, cv::Scalar::all(0), cv::Scalar::all(30));
+    rgb += noise;
+    
+    static const cv::Scalar colors[] = { cv::Scalar(220, 40, 40), cv::Scalar(40, 200, 40), cv::Scalar(40, 40, 220) };
+    std::uniform_int_distribution<int> countDistribution(1, 5);
+    std::uniform_int_distribution<int> colorDistribution(0, 2);
+    std::uniform_real_distribution<double> unitDistribution(0, 1);
+    int numberOfBlobs = countDistribution(gen);
+    for (int i = 0; i < numberOfBlobs; i++) {
+        int radius = (int)(height * (0.01 + 0.19 * unitDistribution(gen)));
+        cv::Point center((int)(width * unitDistribution(gen)), (int)(height * unitDistribution(gen)));
+        cv::circle(rgb, center, std::max(radius, 1), colors[colorDistribution(gen)], cv::FILLED);
+    }
+    
+    std::vector<uint8_t> frame(frameSize(width, height, colorSpace));
+    cv::Mat planes[Eye::maxNumberOfPlanes];
+    framePlanes(frame.data(), width, height, colorSpace, planes);
+    
+    switch (colorSpace) {
+        case ColorSpaceBGRA:
+            cv::cvtColor(rgb, planes[0], cv::COLOR_RGB2BGRA);
+            break;
+        case ColorSpaceNV12:
+        case ColorSpaceI420: {
+            cv::Mat i420;
+            cv::cvtColor(rgb, i420, cv::COLOR_RGB2YUV_I420);
+            if (colorSpace == ColorSpaceI420) {
+                memcpy(frame.data(), i420.data, frame.size());
+            } else {
+                cv::Mat i420Planes[Eye::maxNumberOfPlanes];
+                framePlanes(i420.data, width, height, ColorSpaceI420, i420Planes);
+                i420Planes[0].copyTo(planes[0]);
+                cv::merge(&i420Planes[1], 2, planes[1]);
+            }
+            break;
+        }
+        case ColorSpaceBayerRGGB:
+        case ColorSpaceBayerBGGR: {
+            // Every sample keeps one channel of its pixel
+            int redParity = colorSpace == ColorSpaceBayerRGGB ? 0 : 1;
+            for (int y = 0; y < height; y++) {
+                const uint8_t *pixel = rgb.ptr<uint8_t>(y);
+                uint8_t *sample = frame.data() + (size_t)y * width;
+                for (int x = 0; x < width; x++, pixel += 3) {
+                    bool redRow = y % 2 == redParity;
+                    bool redColumn = x % 2 == redParity;
+                    sample[x] = redRow && redColumn ? pixel[0] : !redRow && !redColumn ? pixel[2] : pixel[1];
+                }
+            }
+            break;
+        }
+        default:
+            rgb.copyTo(planes[0]);
+            break;
+    }
+    return frame;
+}
+
+// MARK: - Benchmark
+
+/// Runs vision stages of both eyes on frames, cycling through them.
+static void benchmark(const std::string &scenario, const std::vector<std::vector<uint8_t>> &frames,
+                      int width, int height, ColorSpace colorSpace, int numberOfFrames, bool blobTracking)
+{
+    const cv::Size eyeSize(227, 227);
+    const int numberOfEyes = 2;
+    
+    BrainWorker worker;
+    worker.setVideoSize(width, height);
+    worker.setColorSpace(colorSpace);
+    worker.setBlobTracking(blobTracking);
+    worker.setFrameChangeThreshold(0);
+    
+    Eye eyes[numberOfEyes];
+    std::vector<Stage> stages = { Stage("resample"), Stage("classify"), Stage("motion"), Stage("label"), Stage("score"),
+                                  Stage("submit"), Stage("vision") };
+    Stage & resampleStage = stages[0];
+    Stage & classifyStage = stages[1];
+    Stage & motionStage = stages[2];
+    Stage & labelStage = stages[3];
+    Stage & scoreStage = stages[4];
+    Stage & submitStage = stages[5];
+    Stage & visionStage = stages[6];
+    
+    // Same crops as vision uses
+    int y = 0;
+    int size = height;
+    if (height > width) {
+        size = (int)((float)width * 0.8);
+        y = (height - size) / 2;
+    }
+    cv::Rect eyeCuts[numberOfEyes] = { cv::Rect(0, y, size, size), cv::Rect(width - size, y, size, size) };
+    bool bayer = colorSpace == ColorSpaceBayerRGGB || colorSpace == ColorSpaceBayerBGGR;
+    
+    for (int n = 0; n < numberOfWarmUpFrames + numberOfFrames; n++) {
+        const std::vector<uint8_t> & frame = frames[n % frames.size()];
+        bool recorded = n >= numberOfWarmUpFrames;
+        
+        cv::Mat planes[Eye::maxNumberOfPlanes];
+        int numberOfPlanes = framePlanes((uint8_t *)frame.data(), width, height, colorSpace, planes);
+        
+        for (int nCam = 0; nCam < numberOfEyes; nCam++) {
+            Eye & eye = eyes[nCam];
+            cv::Rect cuts[Eye::maxNumberOfPlanes];
+            for (int p = 0; p < numberOfPlanes; p++) {
+                cv::Rect cut = eyeCuts[nCam];
+                cuts[p] = p == 0 && !bayer ? cut : cv::Rect(cut.x / 2, cut.y / 2, cut.width / 2, cut.height / 2);
+            }
+            
+            measure(resampleStage, recorded, [&]() {
+                if (numberOfPlanes == 1) {
+                    eye.resamplers[0].resample(planes[0], cuts[0], eye.frame, eyeSize);
+                } else {
+                    for (int p = 0; p < numberOfPlanes; p++) {
+                        eye.resamplers[p].resample(planes[p], cuts[p], eye.planes[p], eyeSize);
+                    }
+                    EyeResampler::interleave(eye.planes, numberOfPlanes, eye.frame);
+                }
+            });
+            measure(classifyStage, recorded, [&]() {
+                ColorClassifier::classify(eye.frame, colorSpace, eye.colorMasks);
+            });
+            measure(motionStage, recorded, [&]() {
+                double energies[MotionDetector::numberOfBands];
+                eye.motionDetector.measure(eye.frame, colorSpace, energies);
+            });
+            
+            Blob blobs[ColorClassifier::numberOfColors];
+            measure(labelStage, recorded, [&]() {
+                for (int color = 0; color < ColorClassifier::numberOfColors; color++) {
+                    BlobDetector & detector = eye.blobDetectors[color];
+                    blobs[color] = blobTracking ? detector.trackLargestBlob(eye.colorMasks[color]) : detector.largestBlob(eye.colorMasks[color]);
+                }
+            });
+            measure(scoreStage, recorded, [&]() {
+                for (int color = 0; color < ColorClassifier::numberOfColors; color++) {
+                    eye.scores[color] = worker.calculateScore(blobs[color], (CameraType)nCam);
+                }
+            });
+        }
+        
+        measure(submitStage, recorded, [&]() {
+            worker.setVideo(frame.data());
+        });
+        measure(visionStage, recorded, [&]() {
+            worker.processVisualInput();
+        });
+    }
+    
+    report(scenario, stages);
+}
+
+static int replay(const std::string &path, int width, int height, ColorSpace colorSpace, int numberOfFrames, bool blobTracking)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return 1;
+    }
+    
+    std::vector<std::vector<uint8_t>> frames;
+    std::vector<uint8_t> frame(frameSize(width, height, colorSpace));
+    while (file.read((char *)frame.data(), frame.size())) {
+        frames.push_back(frame);
+    }
+    if (frames.empty()) {
+        std::cerr << "Recording doesn't contain a whole frame" << std::endl;
+        return 1;
+    }
+    
+    std::string scenario = path + " " + std::to_string(width) + "x" + std::to_string(height) + " " + colorSpaceName(colorSpace)
+        + ", " + std::to_string(frames.size()) + " frames";
+    benchmark(scenario, frames, width, height, colorSpace, numberOfFrames, blobTracking);
+    return 0;
+}
+
+int main(int argc, const char * argv[])
+{
+    int numberOfFrames = 200;
+    bool blobTracking = false;
+    std::string recordingPath;
+    int recordingWidth = 0;
+    int recordingHeight = 0;
+    ColorSpace recordingColorSpace = ColorSpaceRGB;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            numberOfFrames = std::max(atoi(argv[++i]), 1);
+        } else if (arg == "-t") {
+            blobTracking = true;
+        } else if (arg == "-r" && i + 3 < argc) {
+            recordingPath = argv[++i];
+            if (sscanf(argv[++i], "%dx%d", &recordingWidth, &recordingHeight) != 2 || recordingWidth <= 0 || recordingHeight <= 0
+                || parseColorSpace(argv[++i], recordingColorSpace) != 0) {
+                std::cerr << "Invalid recording format" << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "usage: benchmark [-n <numberOfFrames>] [-t] [-r <recording> <width>x<height> <rgb|bgra|nv12|i420|rggb|bggr>]" << std::endl;
+            return 1;
+        }
+    }
+    
+    if (!recordingPath.empty()) {
+        return replay(recordingPath, recordingWidth, recordingHeight, recordingColorSpace, numberOfFrames, blobTracking);
+    }
+    
+    static const cv::Size resolutions[] = { cv::Size(640, 480), cv::Size(1280, 720), cv::Size(1920, 1080), cv::Size(3840, 2160) };
+    static const ColorSpace colorSpaces[] = { ColorSpaceRGB, ColorSpaceBGRA, ColorSpaceNV12, ColorSpaceI420, ColorSpaceBayerRGGB };
+    std::mt19937 gen(42);
+    
+    for (const cv::Size &resolution : resolutions) {
+        for (ColorSpace colorSpace : colorSpaces) {
+            std::vector<std::vector<uint8_t>> frames;
+            for (int i = 0; i < numberOfSyntheticFrames; i++) {
+                frames.push_back(syntheticFrame(resolution.width, resolution.height, colorSpace, gen));
+            }
+            
+            std::string scenario = std::to_string(resolution.width) + "x" + std::to_string(resolution.height) + " " + colorSpaceName(colorSpace);
+            benchmark(scenario, frames, resolution.width, resolution.height, colorSpace, numberOfFrames, blobTracking);
+        }
+    }
+    
+    return 0;
+}
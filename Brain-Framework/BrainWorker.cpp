@@ -15,8 +15,13 @@
 
 BrainWorker::~BrainWorker()
 {
-    if (whileLoopIsRunning) {
-        semaphore.wait();
+    stop();
+    
+    // Frames which are still in mailboxes are given back to their owners
+    for (int source = 0; source < maxNumberOfSources; source++) {
+        for (int i = 0; i < 3; i++) {
+            videoFrames[source].buffer(i).release();
+        }
     }
 }
 
@@ -26,20 +31,401 @@ int BrainWorker::load(std::string filePath_)
         stop();
     }
     
+    compiler.unload();
+    
     return brain.load(filePath_, msPerStep, nStepsPerLoop);
 }
 
+int BrainWorker::compile(std::string cacheDirectory)
+{
+    // Simulation thread runs the loaded kernel without locking
+    if (isRunning) {
+        return 1;
+    }
+    
+    return compiler.load(brain, cacheDirectory);
+}
+
+void BrainWorker::setSpikeExchange(std::shared_ptr<SpikeExchange> exchange)
+{
+    spikeExchange = exchange;
+    exchangeStep = 0;
+}
+
+int BrainWorker::getNumberOfNeurons()
+{
+    return (int)brain.neurons.size();
+}
+
 void BrainWorker::setVideoSize(int width_, int height_)
 {
     cols = width_;
     rows = height_;
 }
 
+/// Capture time given by caller, submission time if it wasn't given.
+static std::chrono::steady_clock::time_point captureTimeOrNow(std::chrono::steady_clock::time_point captureTime)
+{
+    return captureTime == std::chrono::steady_clock::time_point() ? std::chrono::steady_clock::now() : captureTime;
+}
+
+void BrainWorker::setVideo(const uint8_t *frame, int source, std::chrono::steady_clock::time_point captureTime)
+{
+    if (source < 0 || source >= maxNumberOfSources) {
+        return;
+    }
+    
+    VideoFrame & videoFrame = videoFrames[source].writeBuffer();
+    std::vector<uint8_t> & buffer = videoFrame.data;
+    
+    // Allocates only until each of the three buffers has the right size
+    buffer.resize(videoFrameSize());
+    memcpy(buffer.data(), frame, buffer.size());
+    
+    videoFrame.captureTime = captureTimeOrNow(captureTime);
+    videoFrame.colorSpace = colorSpace;
+    contiguousPlanes(buffer.data(), cols * bytesPerPixel(colorSpace), colorSpace, cols, rows, videoFrame.planes, videoFrame.bytesPerRow);
+    publishVideoFrame(source, cols, rows);
+}
+
+int BrainWorker::submitVideo(const uint8_t *frame, size_t bytesPerRow, ColorSpace format, VideoFrameRelease release, void *context, int source,
+                             std::chrono::steady_clock::time_point captureTime)
+{
+    const uint8_t *planes[VideoFrame::maxNumberOfPlanes];
+    size_t planeBytesPerRow[VideoFrame::maxNumberOfPlanes];
+    int numberOfPlanes = contiguousPlanes(frame, bytesPerRow, format, cols, rows, planes, planeBytesPerRow);
+    return submitFrame(planes, planeBytesPerRow, numberOfPlanes, format, cols, rows, release, context, source, captureTime);
+}
+
+int BrainWorker::submitVideoPlanes(const uint8_t *const *planes, const size_t *bytesPerRow, int numberOfPlanes, int chromaPixelStride, ColorSpace format,
+                                   VideoFrameRelease release, void *context, int source, std::chrono::steady_clock::time_point captureTime)
+{
+    // I420 planes whose chroma samples are interleaved in U, V order are NV12 whose chroma plane starts at U
+    bool planar = format == ColorSpaceNV12 || format == ColorSpaceI420;
+    if (format == ColorSpaceI420 && chromaPixelStride == 2 && numberOfPlanes == 3 && planes[1] && planes[2] == planes[1] + 1
+        && bytesPerRow[1] == bytesPerRow[2]) {
+        format = ColorSpaceNV12;
+        numberOfPlanes = 2;
+    } else if (planar && chromaPixelStride != (format == ColorSpaceNV12 ? 2 : 1)) {
+        if (release) {
+            release(context);
+        }
+        return 1;
+    }
+    return submitFrame(planes, bytesPerRow, numberOfPlanes, format, cols, rows, release, context, source, captureTime);
+}
+
+int BrainWorker::submitEyeFrame(int eye, const uint8_t *frame, int width, int height, size_t bytesPerRow, ColorSpace format, VideoFrameRelease release,
+                                void *context, std::chrono::steady_clock::time_point captureTime)
+{
+    // Each pre-cropped eye has its own source
+    const uint8_t *planes[VideoFrame::maxNumberOfPlanes];
+    size_t planeBytesPerRow[VideoFrame::maxNumberOfPlanes];
+    int numberOfPlanes = contiguousPlanes(frame, bytesPerRow, format, width, height, planes, planeBytesPerRow);
+    return submitFrame(planes, planeBytesPerRow, numberOfPlanes, format, width, height, release, context, eye, captureTime);
+}
+
+int BrainWorker::submitFrame(const uint8_t *const *planes, const size_t *bytesPerRow, int numberOfPlanes, ColorSpace format, int width, int height,
+                             VideoFrameRelease release, void *context, int source, std::chrono::steady_clock::time_point captureTime)
+{
+    size_t packedBytesPerRow[VideoFrame::maxNumberOfPlanes];
+    bool valid = source >= 0 && source < maxNumberOfSources && width > 0 && height > 0
+        && numberOfPlanes == packedPlanes(format, width, packedBytesPerRow);
+    for (int p = 0; valid && p < numberOfPlanes; p++) {
+        valid = planes[p] && bytesPerRow[p] >= packedBytesPerRow[p];
+    }
+    if (!valid) {
+        if (release) {
+            release(context);
+        }
+        return 1;
+    }
+    
+    VideoFrame & videoFrame = videoFrames[source].writeBuffer();
+    videoFrame.captureTime = captureTimeOrNow(captureTime);
+    videoFrame.colorSpace = format;
+    std::fill(videoFrame.planes, videoFrame.planes + VideoFrame::maxNumberOfPlanes, (const uint8_t *)NULL);
+    
+    if (release) {
+        // Read in place until vision is done with it
+        std::copy(planes, planes + numberOfPlanes, videoFrame.planes);
+        std::copy(bytesPerRow, bytesPerRow + numberOfPlanes, videoFrame.bytesPerRow);
+        videoFrame.releaseCallback = release;
+        videoFrame.releaseContext = context;
+    } else {
+        // Rows are packed while copying, since caller may reuse its buffer
+        size_t size = 0;
+        for (int p = 0; p < numberOfPlanes; p++) {
+            size += packedBytesPerRow[p] * (p == 0 ? height : (height + 1) / 2);
+        }
+        std::vector<uint8_t> & buffer = videoFrame.data;
+        buffer.resize(size);
+        
+        uint8_t *plane = buffer.data();
+        for (int p = 0; p < numberOfPlanes; p++) {
+            videoFrame.planes[p] = plane;
+            videoFrame.bytesPerRow[p] = packedBytesPerRow[p];
+            plane += packedBytesPerRow[p] * (p == 0 ? height : (height + 1) / 2);
+        }
+        
+        cv::Mat framePlanes[Eye::maxNumberOfPlanes];
+        cv::Mat copiedPlanes[Eye::maxNumberOfPlanes];
+        int numberOfMats = videoPlanes(planes, bytesPerRow, format, width, height, framePlanes);
+        videoPlanes(videoFrame.planes, videoFrame.bytesPerRow, format, width, height, copiedPlanes);
+        for (int m = 0; m < numberOfMats; m++) {
+            framePlanes[m].copyTo(copiedPlanes[m]);
+        }
+    }
+    publishVideoFrame(source, width, height);
+    return 0;
+}
+
+void BrainWorker::publishVideoFrame(int source, int width, int height)
+{
+    VideoFrame & videoFrame = videoFrames[source].writeBuffer();
+    videoFrame.width = width;
+    videoFrame.height = height;
+    videoFrame.sequenceNumber = ++videoSequenceNumber;
+    
+    // Frame which vision didn't take in time is given back to its owner right away
+    if (videoFrames[source].publish()) {
+        videoFrames[source].writeBuffer().release();
+    }
+    frameSemaphore.signal();
+}
+
+int BrainWorker::setEyeLayout(const std::vector<EyeRegion> &layout)
+{
+    if (isRunning) {
+        return 1;
+    }
+    for (const EyeRegion &region : layout) {
+        bool wholeFrame = region.rect.area() == 0 && region.rect.x == 0 && region.rect.y == 0;
+        bool knownCamera = region.camera == CameraTypeLeft || region.camera == CameraTypeRight;
+        if (region.source < 0 || region.source >= maxNumberOfSources || region.rect.width < 0 || region.rect.height < 0
+            || (region.rect.area() == 0 && !wholeFrame) || !knownCamera) {
+            return 1;
+        }
+    }
+    
+    eyeLayout = layout;
+    return 0;
+}
+
+int BrainWorker::setPreCroppedEyes(int numberOfEyes)
+{
+    if (numberOfEyes < 1 || numberOfEyes > maxNumberOfSources) {
+        return 1;
+    }
+    
+    // Eyes alternate sides like the default layout, left eye first
+    std::vector<EyeRegion> layout(numberOfEyes);
+    for (int eye = 0; eye < numberOfEyes; eye++) {
+        layout[eye].source = eye;
+        layout[eye].camera = eye % 2 == 0 ? CameraTypeLeft : CameraTypeRight;
+    }
+    return setEyeLayout(layout);
+}
+
+const std::vector<EyeRegion> & BrainWorker::currentEyeLayout()
+{
+    if (!eyeLayout.empty()) {
+        return eyeLayout;
+    }
+    
+    int y = 0;
+    int size = rows;
+    
+    if (rows > cols) {
+        size = (int)((float)cols * 0.8);
+        y = (rows - size) / 2;
+    }
+    
+    defaultLayout.resize(2);
+    defaultLayout[0].rect = cv::Rect(0, y, size, size);
+    defaultLayout[0].camera = CameraTypeLeft;
+    defaultLayout[1].rect = cv::Rect(cols - size, y, size, size);
+    defaultLayout[1].camera = CameraTypeRight;
+    return defaultLayout;
+}
+
+size_t BrainWorker::videoFrameSize()
+{
+    if (colorSpace == ColorSpaceNV12 || colorSpace == ColorSpaceI420) {
+        // Full resolution luma and two chroma channels subsampled by 2 in both directions
+        return (size_t)cols * rows + (size_t)((cols + 1) / 2) * ((rows + 1) / 2) * 2;
+    }
+    return (size_t)cols * rows * bytesPerPixel(colorSpace);
+}
+
+int BrainWorker::bytesPerPixel(ColorSpace format)
+{
+    switch (format) {
+        case ColorSpaceBGRA:
+            return 4;
+        case ColorSpaceRGB:
+            return 3;
+        default:
+            // Luma of YUV and samples of Bayer mosaic
+            return 1;
+    }
+}
+
+bool BrainWorker::isBayer(ColorSpace format)
+{
+    return format == ColorSpaceBayerRGGB || format == ColorSpaceBayerBGGR;
+}
+
+int BrainWorker::packedPlanes(ColorSpace format, int width, size_t bytesPerRow[VideoFrame::maxNumberOfPlanes])
+{
+    size_t chromaCols = (width + 1) / 2;
+    bytesPerRow[0] = (size_t)width * bytesPerPixel(format);
+    switch (format) {
+        case ColorSpaceNV12:
+            bytesPerRow[1] = chromaCols * 2;
+            return 2;
+        case ColorSpaceI420:
+            bytesPerRow[1] = bytesPerRow[2] = chromaCols;
+            return 3;
+        default:
+            return 1;
+    }
+}
+
+int BrainWorker::contiguousPlanes(const uint8_t *frame, size_t bytesPerRow, ColorSpace format, int width, int height,
+                                  const uint8_t *planes[VideoFrame::maxNumberOfPlanes], size_t planeBytesPerRow[VideoFrame::maxNumberOfPlanes])
+{
+    int chromaRows = (height + 1) / 2;
+    size_t chromaCols = (width + 1) / 2;
+    planes[0] = frame;
+    planeBytesPerRow[0] = bytesPerRow;
+    
+    // Chroma rows are padded as much as luma rows
+    switch (format) {
+        case ColorSpaceNV12:
+            planes[1] = frame + bytesPerRow * height;
+            planeBytesPerRow[1] = std::max(bytesPerRow, chromaCols * 2);
+            return 2;
+        case ColorSpaceI420:
+            planeBytesPerRow[1] = planeBytesPerRow[2] = std::max((bytesPerRow + 1) / 2, chromaCols);
+            planes[1] = frame + bytesPerRow * height;
+            planes[2] = planes[1] + planeBytesPerRow[1] * chromaRows;
+            return 3;
+        default:
+            return 1;
+    }
+}
+
+int BrainWorker::videoPlanes(const uint8_t *const *framePlanes, const size_t *bytesPerRow, ColorSpace format, int width, int height,
+                             cv::Mat planes[Eye::maxNumberOfPlanes])
+{
+    uint8_t *pixels = (uint8_t *)framePlanes[0];
+    int chromaRows = (height + 1) / 2;
+    int chromaCols = (width + 1) / 2;
+    
+    switch (format) {
+        case ColorSpaceNV12:
+            planes[0] = cv::Mat(height, width, CV_8UC1, pixels, bytesPerRow[0]);
+            planes[1] = cv::Mat(chromaRows, chromaCols, CV_8UC2, (uint8_t *)framePlanes[1], bytesPerRow[1]);
+            return 2;
+        case ColorSpaceI420:
+            planes[0] = cv::Mat(height, width, CV_8UC1, pixels, bytesPerRow[0]);
+            planes[1] = cv::Mat(chromaRows, chromaCols, CV_8UC1, (uint8_t *)framePlanes[1], bytesPerRow[1]);
+            planes[2] = cv::Mat(chromaRows, chromaCols, CV_8UC1, (uint8_t *)framePlanes[2], bytesPerRow[2]);
+            return 3;
+        case ColorSpaceBayerRGGB:
+        case ColorSpaceBayerBGGR:
+            // Top and bottom rows of quads, each quad is a pixel of half resolution
+            planes[0] = cv::Mat(height / 2, width / 2, CV_8UC2, pixels, bytesPerRow[0] * 2);
+            planes[1] = cv::Mat(height / 2, width / 2, CV_8UC2, pixels + bytesPerRow[0], bytesPerRow[0] * 2);
+            return 2;
+        case ColorSpaceBGRA:
+            planes[0] = cv::Mat(height, width, CV_8UC4, pixels, bytesPerRow[0]);
+            return 1;
+        default:
+            planes[0] = cv::Mat(height, width, CV_8UC3, pixels, bytesPerRow[0]);
+            return 1;
+    }
+}
+
+void BrainWorker::setAudio(const float *samples, int numberOfSamples, int sampleRate, std::chrono::steady_clock::time_point captureTime)
+{
+    AudioFrame & audioFrame = audioFrames.writeBuffer();
+    audioFrame.captureTime = captureTimeOrNow(captureTime);
+    audioFrame.sampleRate = sampleRate;
+    audioFrame.samples.assign(samples, samples + numberOfSamples);
+    audioFrames.publish();
+}
+
+void BrainWorker::setDistance(int distance_, std::chrono::steady_clock::time_point captureTime)
+{
+    distance = distance_;
+    distanceCaptureTime = captureTimeOrNow(captureTime).time_since_epoch().count();
+}
+
 void BrainWorker::setColorSpace(ColorSpace colorSpace_)
 {
     colorSpace = colorSpace_;
 }
 
+void BrainWorker::setCatchUpPolicy(CatchUpPolicy policy_, int maxBurst_)
+{
+    catchUpPolicy = policy_;
+    maxBurst = std::max(maxBurst_, 1);
+}
+
+double BrainWorker::getLag()
+{
+    return lag;
+}
+
+void BrainWorker::setFrameChangeThreshold(double threshold)
+{
+    frameChangeThreshold = threshold;
+}
+
+int BrainWorker::setFeatureExtractor(std::shared_ptr<FeatureExtractor> extractor, double budget)
+{
+    // Vision and feature threads read the extractor without locking
+    if (isRunning) {
+        return 1;
+    }
+    
+    featureExtractor = extractor;
+    featureBudget = budget;
+    return 0;
+}
+
+void BrainWorker::setFluidVision(bool enabled)
+{
+    fluidVision = enabled;
+}
+
+void BrainWorker::setMotionVision(bool enabled)
+{
+    motionVision = enabled;
+}
+
+void BrainWorker::setQualityGovernor(bool enabled)
+{
+    qualityGovernorEnabled = enabled;
+}
+
+int BrainWorker::getQualityLevel()
+{
+    return qualityLevel;
+}
+
+void BrainWorker::setBlobTracking(bool enabled)
+{
+    blobTracking = enabled;
+}
+
+double BrainWorker::getVisionStaleness()
+{
+    return visionStaleness;
+}
+
 // MARK: - Simulation
 void BrainWorker::start()
 {
@@ -47,37 +433,180 @@ void BrainWorker::start()
         return;
     }
     
-    videoFrame = new uint8_t[cols * rows * 4];
+    // Simulation stops by itself on fatal errors, its threads may still be exiting
+    joinThreads();
+    
+    // Initial state is visible before the first loop completes
+    publishOutputs();
     
     isRunning = true;
     
-    std::thread simulationThread(&BrainWorker::simulateNextIteration, this);
-    simulationThread.detach();
+    // Vision checks whether feature extraction runs, so it starts after it
+    if (featureExtractor) {
+        featureThread = std::thread(&BrainWorker::runFeatureExtraction, this);
+    }
+    visionThread = std::thread(&BrainWorker::runVision, this);
+    
+    simulationThread = std::thread(&BrainWorker::simulateNextIteration, this);
 }
 
 void BrainWorker::stop()
 {
     isRunning = false;
+    joinThreads();
+}
+
+void BrainWorker::joinThreads()
+{
+    if (simulationThread.joinable()) {
+        simulationThread.join();
+    }
+    
+    // Wake up vision in case it waits for a frame
+    if (visionThread.joinable()) {
+        frameSemaphore.signal();
+        visionThread.join();
+    }
+    if (featureThread.joinable()) {
+        eyeFramesSemaphore.signal();
+        featureThread.join();
+    }
+}
+
+void BrainWorker::runVision()
+{
+    int numberOfFrames = 0;
+    
+    while (isRunning) {
+        frameSemaphore.wait();
+        
+        // Skipped frames are released by camera thread once newer frames replace them
+        const QualityLevel & quality = QualityGovernor::levels[qualityLevel];
+        if (isRunning && ++numberOfFrames % quality.visionFrameInterval == 0) {
+            processVisualInput();
+        }
+    }
+}
+
+void BrainWorker::runFeatureExtraction()
+{
+    int framesToSkip = 0;
+    
+    while (isRunning) {
+        eyeFramesSemaphore.wait();
+        if (!isRunning || !eyeFrames.update()) {
+            continue;
+        }
+        
+        // Frames are skipped to stay within the budget on average
+        if (framesToSkip > 0) {
+            framesToSkip--;
+            continue;
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        EyeFrames & frames = eyeFrames.readBuffer();
+        VisionOutput & output = featureOutputs.writeBuffer();
+        if (featureExtractor->extract(frames.frames, frames.colorSpace, output.visPrefVals) == 0) {
+            output.frameNumber = frames.frameNumber;
+            output.timestamp = frames.timestamp;
+            output.captureTime = frames.captureTime;
+            output.processedTime = std::chrono::steady_clock::now();
+            featureOutputs.publish();
+        }
+        
+        double duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (featureBudget > 0 && duration > featureBudget) {
+            framesToSkip = (int)(duration / featureBudget);
+        }
+    }
 }
 
 void BrainWorker::simulateNextIteration()
 {
+    auto period = std::chrono::milliseconds((long long)nStepsPerLoop);
+    auto startTime = std::chrono::steady_clock::now();
+    auto deadline = startTime;
+    long long numberOfLoops = 0;
+    bool skipSensors = false;
+    int numberOfSkips = 0;
+    
+    lag = 0;
     whileLoopIsRunning = true;
     while (isRunning) {
         
+        auto loopStart = std::chrono::steady_clock::now();
         updateBrain();
         updateMotors();
-        processVisualInput();
-        processAudioInput();
+        publishOutputs();
+        latencyHistograms[LatencyStageLoop].add(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loopStart).count());
+        updateVisualInput();
+        if (!skipSensors) {
+            processAudioInput();
+        }
+        numberOfLoops++;
+        deadline += period;
+        
+        auto now = std::chrono::steady_clock::now();
+        skipSensors = false;
+        
+        // Vision doesn't run in the loop, but its frames have to keep up with it
+        if (qualityGovernorEnabled) {
+            double loopLoad = std::chrono::duration<double>(now - loopStart) / period;
+            qualityLevel = qualityGovernor.update(std::max(loopLoad, (double)visionLoad));
+        } else {
+            // Governor is reset here, so its level can't be stored after disabling it
+            qualityGovernor.reset();
+            qualityLevel = 0;
+        }
+        
+        if (catchUpPolicy == CatchUpPolicyNone) {
+            std::this_thread::sleep_for(period);
+        } else if (now < deadline) {
+            numberOfSkips = 0;
+            std::this_thread::sleep_until(deadline);
+        } else if (catchUpPolicy == CatchUpPolicySkipSensors && numberOfSkips < maxBurst) {
+            numberOfSkips++;
+            skipSensors = true;
+        } else if (catchUpPolicy == CatchUpPolicyBurst) {
+            long long missedLoops = (now - deadline) / period + 1;
+            int numberOfBurstLoops = runBurst((int)std::min<long long>(missedLoops, maxBurst));
+            numberOfLoops += numberOfBurstLoops;
+            deadline += period * numberOfBurstLoops;
+            
+            // Declare what's left after the burst
+            now = std::chrono::steady_clock::now();
+            if (now > deadline) {
+                deadline = now;
+            }
+        } else {
+            numberOfSkips = 0;
+            deadline = now;
+        }
+        
+        auto behind = std::chrono::steady_clock::now() - startTime - period * numberOfLoops;
+        lag = std::max(std::chrono::duration<double, std::milli>(behind).count(), 0.0);
         
-        std::this_thread::sleep_for(std::chrono::milliseconds((long long)nStepsPerLoop));
         semaphore.signal();
     }
     whileLoopIsRunning = false;
 }
 
+int BrainWorker::runBurst(int numberOfLoops)
+{
+    int i = 0;
+    for (; i < numberOfLoops && isRunning; i++) {
+        updateBrain();
+        updateMotors();
+        publishOutputs();
+    }
+    return i;
+}
+
 void BrainWorker::updateBrain()
 {
+    distanceInUseTime = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(distanceCaptureTime.load()));
+    
     // Reset all the parameters
     for (int i = 0; i < brain.numberOfNeurons; i++) {
         Neuron & neuron = brain.neurons[i];
@@ -91,15 +620,16 @@ void BrainWorker::updateBrain()
         }
     }
     
-    // Count sum of vis pref vals
+    // Count sum of vis pref vals, brain file sets number of cameras
+    size_t numberOfCameras = brain.visPrefVals.empty() ? 0 : brain.visPrefVals.front().size();
     for (int i = 0; i < brain.numberOfNeurons; i++) {
         Neuron & neuron = brain.neurons[i];
         
         // Calculate visual input current
-        for (int ncam = 0; ncam < 2; ncam++) {
+        for (size_t ncam = 0; ncam < numberOfCameras; ncam++) {
             double sum = 0;
             for (int t = 0; t < neuron.visPref.size(); t++) {
-                if (neuron.visPref[t][ncam]) {
+                if (ncam < neuron.visPref[t].size() && neuron.visPref[t][ncam]) {
                     sum += brain.visPrefVals[t][ncam];
                 }
             }
@@ -145,55 +675,86 @@ void BrainWorker::updateBrain()
     std::mt19937 gen{ rd() };
     std::normal_distribution<double> distribution(0.0, 1.0);
     
+    // Range of neurons simulated by this process
+    int firstNeuron = 0;
+    int lastNeuron = brain.numberOfNeurons;
+    if (spikeExchange) {
+        int shardIndex = spikeExchange->shardIndex();
+        int numberOfShards = spikeExchange->numberOfShards();
+        firstNeuron = (int)((long)brain.numberOfNeurons * shardIndex / numberOfShards);
+        lastNeuron = (int)((long)brain.numberOfNeurons * (shardIndex + 1) / numberOfShards);
+    }
+    
     // Run brain simulation
-    for (int t = 0; t < msPerStep; t++) {
-        
-        for (int i = 0; i < brain.numberOfNeurons; i++) {
-            Neuron & neuron = brain.neurons[i];
-            
-            // Add noise
-            double randomNumber = distribution(gen);
-            neuron.I = 5 * randomNumber;
-        }
-        
-        for (int i = 0; i < brain.numberOfNeurons; i++) {
-            Neuron & neuron = brain.neurons[i];
+    if (compiler.getKernel() != NULL && !spikeExchange && compiler.getNumberOfNeurons() == (int)brain.neurons.size()) {
+        runCompiledBrain(gen, distribution);
+    } else {
+        for (int t = 0; t < msPerStep; t++) {
             
-            // Find spiking neurons
-            if (neuron.v >= 30) {
-                neuron.spikesStep[t] = 1;
+            for (int i = firstNeuron; i < lastNeuron; i++) {
+                Neuron & neuron = brain.neurons[i];
                 
-                // Reset spiking v to c
-                neuron.v = neuron.c;
+                // Add noise
+                double randomNumber = distribution(gen);
+                neuron.I = 5 * randomNumber;
+            }
+            
+            localSpikes.clear();
+            for (int i = firstNeuron; i < lastNeuron; i++) {
+                Neuron & neuron = brain.neurons[i];
                 
-                // Adjust spiking u to d
-                neuron.u = neuron.u + neuron.d;
+                // Find spiking neurons
+                if (neuron.v >= 30) {
+                    localSpikes.push_back(i);
+                    
+                    // Reset spiking v to c
+                    neuron.v = neuron.c;
+                    
+                    // Adjust spiking u to d
+                    neuron.u = neuron.u + neuron.d;
+                }
+            }
+            
+            // Collect spikes of other shards
+            std::vector<int> *spikes = &localSpikes;
+            if (spikeExchange) {
+                if (spikeExchange->exchange(exchangeStep++, localSpikes, allSpikes) != 0) {
+                    std::cout << "spike exchange failed, stopping brain" << std::endl;
+                    isRunning = false;
+                    allSpikes.clear();
+                }
+                spikes = &allSpikes;
+            }
+            
+            for (int i : *spikes) {
+                Neuron & neuron = brain.neurons[i];
+                neuron.spikesStep[t] = 1;
                 
                 // Add spiking synaptic weights to neuronal inputs
-                for (int k = 0; k < brain.numberOfNeurons; k++) {
+                for (int k = firstNeuron; k < lastNeuron; k++) {
                     Neuron & neuron2 = brain.neurons[k];
                     neuron2.I = neuron2.I + neuron.connectToMe[k];
                 }
             }
-        }
-        
-        for (int i = 0; i < brain.numberOfNeurons; i++) {
-            Neuron & neuron = brain.neurons[i];
-            
-            // Add sensory input currents
-            neuron.I = neuron.I + neuron.visI + neuron.distI + neuron.audioI;
-            neuron.iStep[t] = neuron.I;
-            
-            // Update v
-            neuron.v = neuron.v + 0.5 * (0.04 * std::pow(neuron.v, 2) + 5 * neuron.v + 140 - neuron.u + neuron.I);
-            neuron.v = neuron.v + 0.5 * (0.04 * std::pow(neuron.v, 2) + 5 * neuron.v + 140 - neuron.u + neuron.I);
             
-            // Update u
-            neuron.u = neuron.u + neuron.a * (neuron.b * neuron.v - neuron.u);
-            
-            // Avoid nans
-            if (std::isnan(neuron.v)) {
-                neuron.v = neuron.c;
+            for (int i = firstNeuron; i < lastNeuron; i++) {
+                Neuron & neuron = brain.neurons[i];
+                
+                // Add sensory input currents
+                neuron.I = neuron.I + neuron.visI + neuron.distI + neuron.audioI;
+                neuron.iStep[t] = neuron.I;
+                
+                // Update v
+                neuron.v = neuron.v + 0.5 * (0.04 * std::pow(neuron.v, 2) + 5 * neuron.v + 140 - neuron.u + neuron.I);
+                neuron.v = neuron.v + 0.5 * (0.04 * std::pow(neuron.v, 2) + 5 * neuron.v + 140 - neuron.u + neuron.I);
+                
+                // Update u
+                neuron.u = neuron.u + neuron.a * (neuron.b * neuron.v - neuron.u);
+                
+                // Avoid nans
+                if (std::isnan(neuron.v)) {
+                    neuron.v = neuron.c;
+                }
             }
         }
     }
@@ -210,178 +771,315 @@ void BrainWorker::updateBrain()
     }
 }
 
-void BrainWorker::processVisualInput()
+void BrainWorker::runCompiledBrain(std::mt19937 &gen, std::normal_distribution<double> &distribution)
 {
-    if (videoFrame != 0) {
-        
-        cv::Size netInputSize(colsResized, rowsResized);
-        
-        int y = 0;
-        int size = rows;
-        
-        if (rows > cols) {
-            size = (int)((float)cols * 0.8);
-            y = (rows - size) / 2;
+    int numberOfNeurons = (int)brain.neurons.size();
+    int numberOfSteps = (int)msPerStep;
+    
+    kernelV.resize(numberOfNeurons);
+    kernelU.resize(numberOfNeurons);
+    kernelSensoryI.resize(numberOfNeurons);
+    kernelNoise.resize(numberOfNeurons * numberOfSteps);
+    kernelIStep.resize(numberOfNeurons * numberOfSteps);
+    kernelSpikes.assign(numberOfNeurons * numberOfSteps, 0);
+    
+    for (int i = 0; i < numberOfNeurons; i++) {
+        Neuron & neuron = brain.neurons[i];
+        kernelV[i] = neuron.v;
+        kernelU[i] = neuron.u;
+        kernelSensoryI[i] = neuron.visI + neuron.distI + neuron.audioI;
+    }
+    
+    // Noise is drawn in the same order as in generic simulation
+    for (int t = 0; t < numberOfSteps * numberOfNeurons; t++) {
+        kernelNoise[t] = 5 * distribution(gen);
+    }
+    
+    compiler.getKernel()(kernelV.data(), kernelU.data(), kernelSensoryI.data(), kernelNoise.data(), kernelIStep.data(), kernelSpikes.data(), numberOfSteps);
+    
+    for (int i = 0; i < numberOfNeurons; i++) {
+        Neuron & neuron = brain.neurons[i];
+        neuron.v = kernelV[i];
+        neuron.u = kernelU[i];
+        for (int t = 0; t < numberOfSteps; t++) {
+            neuron.spikesStep[t] = kernelSpikes[t * numberOfNeurons + i];
+            neuron.iStep[t] = kernelIStep[t * numberOfNeurons + i];
         }
-        
-        int bytePattern = CV_8UC3;
-        if (colorSpace == ColorSpaceBGRA) {
-            bytePattern = CV_8UC4;
+    }
+}
+
+void BrainWorker::processVisualInput()
+{
+    // Take the newest complete frame of every source, frames which arrived meanwhile are dropped
+    bool hasNewFrame = false;
+    for (int source = 0; source < maxNumberOfSources; source++) {
+        hasNewFrame = videoFrames[source].update() || hasNewFrame;
+    }
+    if (!hasNewFrame) {
+        return;
+    }
+    auto timestamp = std::chrono::steady_clock::now();
+    eyeSize = featureExtractor ? rowsResized : QualityGovernor::levels[qualityLevel].eyeSize;
+    
+    // Sources without a complete frame have no planes
+    uint64_t frameNumber = 0;
+    auto captureTime = timestamp;
+    cv::Mat planes[maxNumberOfSources][Eye::maxNumberOfPlanes];
+    int numberOfPlanes[maxNumberOfSources] = {};
+    cv::Rect frameRects[maxNumberOfSources];
+    for (int source = 0; source < maxNumberOfSources; source++) {
+        VideoFrame & videoFrame = videoFrames[source].readBuffer();
+        if (videoFrame.planes[0]) {
+            // Frames keep the size they were submitted with, pre-cropped eye frames differ from video size
+            numberOfPlanes[source] = videoPlanes(videoFrame.planes, videoFrame.bytesPerRow, videoFrame.colorSpace, videoFrame.width, videoFrame.height, planes[source]);
+            frameRects[source] = cv::Rect(0, 0, videoFrame.width, videoFrame.height);
+            frameNumber = std::max(frameNumber, videoFrame.sequenceNumber);
+            captureTime = std::min(captureTime, videoFrame.captureTime);
         }
-        
-        cv::Rect left_cut(0, y, size, size);
-        cv::Rect right_cut(cols - size, y, size, size);
-        int sizes[] = { rows, cols };
-        cv::Mat imageMat(2, sizes, bytePattern, videoFrame);
-        
-        //        cv::imshow("display", imageMat);
-        
-        for (int nCam = 0; nCam < 2; nCam++) {
-            
-            auto cameraType = nCam == 0 ? CameraTypeLeft : CameraTypeRight;
-            
-            cv::Mat bigFrame(rows, rows, bytePattern);
-            
-            cv::Mat frame;
-            
-            if (nCam == 0) {
-                bigFrame = imageMat(left_cut);
-            } else {
-                bigFrame = imageMat(right_cut);
+    }
+    if (frameNumber == 0) {
+        releaseVideoFrames();
+        return;
+    }
+    
+    //        cv::imshow("display", planes[0][0]);
+    
+    const std::vector<EyeRegion> & layout = currentEyeLayout();
+    int numberOfEyes = (int)layout.size();
+    while ((int)eyes.size() < numberOfEyes) {
+        eyes.push_back(std::unique_ptr<Eye>(new Eye()));
+    }
+    eyes.resize(numberOfEyes);
+    
+    double changeThreshold = frameChangeThreshold;
+    
+    // Eyes share only source frames, so they are processed concurrently as one batch
+    cv::parallel_for_(cv::Range(0, numberOfEyes), [&](const cv::Range &range) {
+        for (int nCam = range.start; nCam < range.end; nCam++) {
+            Eye & eye = *eyes[nCam];
+            const EyeRegion & region = layout[nCam];
+            const cv::Rect & frameRect = frameRects[region.source];
+            cv::Rect cut = region.rect.area() == 0 ? frameRect : region.rect & frameRect;
+            int numberOfEyePlanes = numberOfPlanes[region.source];
+            ColorSpace frameColorSpace = videoFrames[region.source].readBuffer().colorSpace;
+            bool bayer = isBayer(frameColorSpace);
+            if (numberOfEyePlanes == 0 || cut.width < (bayer ? 4 : 2) || cut.height < (bayer ? 4 : 2)) {
+                continue;
             }
             
-            cv::resize(bigFrame, frame, netInputSize);
-            
-            auto scoreRed = calculateScore(ColorRed, frame, cameraType);
-            
-            brain.visPrefVals[0][nCam] = scoreRed.thisScore;
-            brain.visPrefVals[1][nCam] = scoreRed.temporalScore;
-            
-            auto scoreGreen = calculateScore(ColorGreen, frame, cameraType);
-            
-            brain.visPrefVals[2][nCam] = scoreGreen.thisScore;
-            brain.visPrefVals[3][nCam] = scoreGreen.temporalScore;
-            
-            auto scoreBlue = calculateScore(ColorBlue, frame, cameraType);
+            // Chroma planes are subsampled by 2, planes of Bayer quads are all half resolution
+            cv::Rect cuts[Eye::maxNumberOfPlanes];
+            for (int p = 0; p < numberOfEyePlanes; p++) {
+                cuts[p] = p == 0 && !bayer ? cut : cv::Rect(cut.x / 2, cut.y / 2, cut.width / 2, cut.height / 2);
+            }
             
-            brain.visPrefVals[4][nCam] = scoreBlue.thisScore;
-            brain.visPrefVals[5][nCam] = scoreBlue.temporalScore;
+            // Scores of unchanged eye are reused, it didn't see any motion
+            eye.signature.sample(planes[region.source], cuts, numberOfEyePlanes);
+            if (changeThreshold > 0 && eye.signature.difference() < changeThreshold) {
+                std::fill(eye.motionScores, eye.motionScores + MotionDetector::numberOfBands, 0);
+                continue;
+            }
+            eye.signature.markProcessed();
+            processEye(eye, region.camera, frameColorSpace, planes[region.source], cuts, numberOfEyePlanes);
+        }
+    });
+    releaseVideoFrames();
+    
+    VisionOutput & output = visionOutputs.writeBuffer();
+    output.visPrefVals.resize(numberOfVisionRows());
+    for (int color = 0; color < ColorClassifier::numberOfColors; color++) {
+        output.visPrefVals[color * 2].resize(numberOfEyes);
+        output.visPrefVals[color * 2 + 1].resize(numberOfEyes);
+        for (int nCam = 0; nCam < numberOfEyes; nCam++) {
+            output.visPrefVals[color * 2][nCam] = eyes[nCam]->scores[color].thisScore;
+            output.visPrefVals[color * 2 + 1][nCam] = eyes[nCam]->scores[color].temporalScore;
+        }
+    }
+    // Motion rows follow color rows, they stay zero while motion isn't measured
+    for (int band = 0; band < MotionDetector::numberOfBands; band++) {
+        std::vector<double> & row = output.visPrefVals[ColorClassifier::numberOfColors * 2 + band];
+        row.resize(numberOfEyes);
+        for (int nCam = 0; nCam < numberOfEyes; nCam++) {
+            row[nCam] = motionVision ? eyes[nCam]->motionScores[band] : 0;
         }
     }
+    auto processedTime = std::chrono::steady_clock::now();
+    output.frameNumber = frameNumber;
+    output.timestamp = timestamp;
+    output.captureTime = captureTime;
+    output.processedTime = processedTime;
+    visionOutputs.publish();
+    
+    latencyHistograms[LatencyStageVideoQueue].add(std::chrono::duration<double, std::milli>(timestamp - captureTime).count());
+    latencyHistograms[LatencyStageVision].add(std::chrono::duration<double, std::milli>(processedTime - timestamp).count());
+    visionLoad = std::chrono::duration<double>(processedTime - timestamp) / std::chrono::milliseconds((long long)nStepsPerLoop);
+    
+    if (featureThread.joinable()) {
+        publishEyeFrames(frameNumber, timestamp, captureTime);
+    }
 }
 
-void BrainWorker::processAudioInput()
+void BrainWorker::releaseVideoFrames()
 {
-    if (audioData.size() > 0) {
-        spectrum = getSpectrum(audioData, audioSampleRate * 0.5);
+    for (int source = 0; source < maxNumberOfSources; source++) {
+        videoFrames[source].readBuffer().release();
     }
 }
 
-Score BrainWorker::calculateScore(ColorType color, cv::Mat frame, CameraType camera)
+void BrainWorker::publishEyeFrames(uint64_t frameNumber, std::chrono::steady_clock::time_point timestamp, std::chrono::steady_clock::time_point captureTime)
 {
-    Score score;
-    
-    cv::Mat boolMat(frame.rows, frame.cols, CV_8UC1);
-    boolMat = boolMat.zeros(frame.rows, frame.cols, CV_8UC1);
-    
-    int firstIndex = 0;
-    int secondIndex = 1;
-    int thirdIndex = 2;
-    double multiplier = 2;
-    
-    if (color == ColorRed) {
-        firstIndex = 0;
-        secondIndex = 1;
-        thirdIndex = 2;
-        multiplier = 1.8;
-        
-        if (colorSpace == ColorSpaceBGRA) {
-            int indexFoo = firstIndex;
-            firstIndex = thirdIndex;
-            thirdIndex = indexFoo;
-        }
-    } else if (color == ColorGreen) {
-        firstIndex = 1;
-        secondIndex = 0;
-        thirdIndex = 2;
-        multiplier = 1.2;
-    } else if (color == ColorBlue) {
-        firstIndex = 2;
-        secondIndex = 1;
-        thirdIndex = 0;
-        multiplier = 1.5;
-        if (colorSpace == ColorSpaceBGRA) {
-            int indexFoo = firstIndex;
-            firstIndex = thirdIndex;
-            thirdIndex = indexFoo;
-        }
-    }
-    
-    if (colorSpace == ColorSpaceRGB) {
-        for (int i = 0; i < frame.rows; i++) {
-            for (int j = 0; j < frame.cols; j++) {
-                if ((frame.at<cv::Vec3b>(i, j)[firstIndex] > frame.at<cv::Vec3b>(i, j)[secondIndex] * multiplier && frame.at<cv::Vec3b>(i, j)[firstIndex] > frame.at<cv::Vec3b>(i, j)[thirdIndex] * multiplier)) {
-                    boolMat.at<bool>(i, j) = true;
-                }
-                if (frame.at<cv::Vec3b>(i, j)[firstIndex] < 50) {
-                    frame.at<cv::Vec3b>(i, j)[firstIndex] = 0;
-                }
-            }
+    EyeFrames & frames = eyeFrames.writeBuffer();
+    frames.frames.resize(eyes.size());
+    for (size_t nCam = 0; nCam < eyes.size(); nCam++) {
+        if (eyes[nCam]->frame.empty()) {
+            return;
         }
-    } else if (colorSpace == ColorSpaceBGRA) {
-        for (int i = 0; i < frame.rows; i++) {
-            for (int j = 0; j < frame.cols; j++) {
-                if ((frame.at<cv::Vec4b>(i, j)[firstIndex] > frame.at<cv::Vec4b>(i, j)[secondIndex] * multiplier && frame.at<cv::Vec4b>(i, j)[firstIndex] > frame.at<cv::Vec4b>(i, j)[thirdIndex] * multiplier)) {
-                    boolMat.at<bool>(i, j) = true;
-                }
-                if (frame.at<cv::Vec4b>(i, j)[firstIndex] < 50) {
-                    frame.at<cv::Vec4b>(i, j)[firstIndex] = 0;
-                }
-            }
+        // Copies into buffers of previous frames, which have the same size
+        eyes[nCam]->frame.copyTo(frames.frames[nCam]);
+    }
+    frames.frameNumber = frameNumber;
+    frames.timestamp = timestamp;
+    frames.captureTime = captureTime;
+    frames.colorSpace = eyes.front()->colorSpace;
+    eyeFrames.publish();
+    eyeFramesSemaphore.signal();
+}
+
+void BrainWorker::updateVisualInput()
+{
+    // Values of the newest processed frame, the last ones are reused if vision didn't finish a new frame
+    if (visionOutputs.update()) {
+        VisionOutput & visionOutput = visionOutputs.readBuffer();
+        copyVisPrefVals(visionOutput, 0);
+        videoCaptureTime = visionOutput.captureTime;
+        auto handoff = std::chrono::steady_clock::now() - visionOutput.processedTime;
+        latencyHistograms[LatencyStageVisionHandoff].add(std::chrono::duration<double, std::milli>(handoff).count());
+    }
+    // Features follow rows of vision
+    if (featureOutputs.update()) {
+        copyVisPrefVals(featureOutputs.readBuffer(), numberOfVisionRows());
+        featureCaptureTime = featureOutputs.readBuffer().captureTime;
+    }
+    
+    VisionOutput & output = visionOutputs.readBuffer();
+    if (output.frameNumber != 0) {
+        auto age = std::chrono::steady_clock::now() - output.timestamp;
+        visionStaleness = std::chrono::duration<double, std::milli>(age).count();
+    }
+}
+
+std::vector<std::vector<double>> BrainWorker::getVisionOutput()
+{
+    visionOutputs.update();
+    return visionOutputs.readBuffer().visPrefVals;
+}
+
+size_t BrainWorker::numberOfVisionRows()
+{
+    // Rows of motion are kept even if it's disabled, so rows of features don't move
+    return ColorClassifier::numberOfColors * 2 + MotionDetector::numberOfBands;
+}
+
+void BrainWorker::copyVisPrefVals(const VisionOutput &output, size_t firstRow)
+{
+    for (size_t i = 0; i < output.visPrefVals.size() && firstRow + i < brain.visPrefVals.size(); i++) {
+        std::vector<double> & row = brain.visPrefVals[firstRow + i];
+        for (size_t nCam = 0; nCam < output.visPrefVals[i].size() && nCam < row.size(); nCam++) {
+            row[nCam] = output.visPrefVals[i][nCam];
         }
     }
+}
+
+void BrainWorker::processEye(Eye &eye, CameraType camera, ColorSpace frameColorSpace, const cv::Mat *planes, const cv::Rect *cuts, int numberOfPlanes)
+{
+    cv::Size netInputSize(eyeSize, eyeSize);
+    eye.colorSpace = frameColorSpace;
     
-    cv::Mat blob(frame.rows, frame.cols, CV_8UC1);
-    int totalNumberOfLabels = cv::connectedComponents(boolMat, blob);
+    // Fluid graph produces color masks directly, native stages are used if it isn't available
+    bool masksReady = fluidVision && !featureExtractor && !motionVision && numberOfPlanes == 1 && FluidEyePipeline::supports(frameColorSpace)
+        && eye.fluidPipeline.process(planes[0], cuts[0], frameColorSpace, netInputSize, eye.colorMasks) == 0;
     
-    if (totalNumberOfLabels > 0) {
-        std::vector<int> sumPerCells(totalNumberOfLabels, 0);
-        for (int i = 0; i < blob.rows; i++) {
-            for (int j = 0; j < blob.cols; j++) {
-                if (blob.at<int>(i, j) != 0 && blob.at<int>(i, j) < sumPerCells.size()) {
-                    sumPerCells[blob.at<int>(i, j)] += 1;
-                }
+    if (!masksReady) {
+        // Crop and resize in one pass into eye's own frame, frames scaled by camera already are only copied
+        if (numberOfPlanes == 1 && cuts[0].size() == netInputSize) {
+            planes[0](cuts[0]).copyTo(eye.frame);
+        } else if (numberOfPlanes == 1) {
+            eye.resamplers[0].resample(planes[0], cuts[0], eye.frame, netInputSize);
+        } else {
+            // Chroma planes are resampled to full eye size and interleaved with luma, rows of Bayer quads with each other
+            for (int p = 0; p < numberOfPlanes; p++) {
+                eye.resamplers[p].resample(planes[p], cuts[p], eye.planes[p], netInputSize);
             }
+            EyeResampler::interleave(eye.planes, numberOfPlanes, eye.frame);
         }
         
-        auto maxElementIndex = std::max_element(sumPerCells.begin(), sumPerCells.end()) - sumPerCells.begin();
-        auto npx = *std::max_element(sumPerCells.begin(), sumPerCells.end());
-        
-        std::vector<float> x;
-        std::vector<int> y;
-        
-        for (int i = 0; i < blob.rows; i++) {
-            for (int j = 0; j < blob.cols; j++) {
-                if (blob.at<int>(i, j) == maxElementIndex) {
-                    y.push_back(i);
-                    x.push_back(j);
-                }
-            }
+        // All colors are classified in one pass
+        ColorClassifier::classify(eye.frame, frameColorSpace, eye.colorMasks);
+    }
+    
+    if (motionVision) {
+        double energies[MotionDetector::numberOfBands];
+        eye.motionDetector.measure(eye.frame, frameColorSpace, energies);
+        for (int band = 0; band < MotionDetector::numberOfBands; band++) {
+            eye.motionScores[band] = MathFunctions::sigmoid(energies[band], 10, 0.5) * 50;
         }
+    }
+    
+    for (int color = 0; color < ColorClassifier::numberOfColors; color++) {
+        BlobDetector & detector = eye.blobDetectors[color];
+        Blob blob = blobTracking ? detector.trackLargestBlob(eye.colorMasks[color]) : detector.largestBlob(eye.colorMasks[color]);
         
-        score.thisScore = MathFunctions::sigmoid(npx, 1000, 0.01) * 50;
-        
-        auto mean = MathFunctions::mean(x);
-        
-        if (camera == CameraTypeLeft) {
-            score.temporalScore = MathFunctions::sigmoid(((227 - mean) / 227), 0.95, 5) * score.thisScore;
-        } else if (camera == CameraTypeRight) {
-            score.temporalScore = MathFunctions::sigmoid((mean / 227), 0.95, 5) * score.thisScore;
+        // Blobs of smaller eye frames are measured in full resolution, so scores don't depend on quality
+        if (eyeSize != colsResized) {
+            double scale = (double)colsResized / eyeSize;
+            blob.area = (int)std::lround(blob.area * scale * scale);
+            blob.centroidX = (blob.centroidX + 0.5) * scale - 0.5;
+            blob.centroidY = (blob.centroidY + 0.5) * scale - 0.5;
         }
-        
-    } else {
-        score.thisScore = 0;
-        score.temporalScore = 0;
+        eye.scores[color] = calculateScore(blob, camera);
+    }
+}
+
+void BrainWorker::processAudioInput()
+{
+    // Spectrum of the newest audio buffer is kept until another one arrives
+    if (!audioFrames.update()) {
+        return;
+    }
+    AudioFrame & audioFrame = audioFrames.readBuffer();
+    const std::vector<float> & audioData = audioFrame.samples;
+    int audioSampleRate = audioFrame.sampleRate;
+    audioCaptureTime = audioFrame.captureTime;
+    
+    int decimation = QualityGovernor::levels[qualityLevel].audioDecimation;
+    if (decimation > 1 && audioData.size() >= (size_t)decimation) {
+        // Averaging keeps frequencies below the new Nyquist frequency
+        decimatedAudio.resize(audioData.size() / decimation);
+        for (size_t i = 0; i < decimatedAudio.size(); i++) {
+            float sum = 0;
+            for (int k = 0; k < decimation; k++) {
+                sum += audioData[i * decimation + k];
+            }
+            decimatedAudio[i] = sum / decimation;
+        }
+        spectrum = getSpectrum(decimatedAudio, audioSampleRate * 0.5 / decimation);
+    } else if (audioData.size() > 0) {
+        spectrum = getSpectrum(audioData, audioSampleRate * 0.5);
+    }
+}
+
+Score BrainWorker::calculateScore(const Blob &blob, CameraType camera)
+{
+    Score score {};
+    
+    score.thisScore = MathFunctions::sigmoid(blob.area, 1000, 0.01) * 50;
+    
+    auto mean = blob.centroidX;
+    
+    if (camera == CameraTypeLeft) {
+        score.temporalScore = MathFunctions::sigmoid(((227 - mean) / 227), 0.95, 5) * score.thisScore;
+    } else if (camera == CameraTypeRight) {
+        score.temporalScore = MathFunctions::sigmoid((mean / 227), 0.95, 5) * score.thisScore;
     }
     
     return score;
@@ -457,19 +1155,95 @@ void BrainWorker::updateMotors()
     std::cout << "speaker frequency: " << speakerTone << std::endl;
 }
 
-// MARK: - Out functions
-
-std::vector<double> BrainWorker::getNeuronValues()
+void BrainWorker::publishOutputs()
 {
     auto numberOfNeurons = brain.neurons.size();
-    std::vector<double> neuronValues(numberOfNeurons);
+    SimulationOutput & output = outputs.writeBuffer();
     
-    for (int i = 0; i < numberOfNeurons; i++) {
-        auto neuron = brain.neurons[i];
-        neuronValues[i] = neuron.v;
+    output.generation = ++generation;
+    output.leftTorque = leftTorque;
+    output.rightTorque = rightTorque;
+    output.speakerTone = speakerTone;
+    
+    // Ages of inputs which the loop used
+    output.timestamp = std::chrono::steady_clock::now();
+    output.videoAge = inputAge(videoCaptureTime, output.timestamp, LatencyStageVideoAge);
+    output.featureAge = inputAge(featureCaptureTime, output.timestamp, LatencyStageFeatureAge);
+    output.audioAge = inputAge(audioCaptureTime, output.timestamp, LatencyStageAudioAge);
+    output.distanceAge = inputAge(distanceInUseTime, output.timestamp, LatencyStageDistanceAge);
+    
+    // Buffers are reused, so no allocation happens once they have the right size
+    output.neuronValues.resize(numberOfNeurons);
+    output.firingNeurons.resize(numberOfNeurons);
+    for (size_t i = 0; i < numberOfNeurons; i++) {
+        Neuron & neuron = brain.neurons[i];
+        output.neuronValues[i] = neuron.v;
+        output.firingNeurons[i] = neuron.firing;
     }
     
-    return neuronValues;
+    outputs.publish();
+}
+
+double BrainWorker::inputAge(std::chrono::steady_clock::time_point captureTime, std::chrono::steady_clock::time_point now, LatencyStage stage)
+{
+    if (captureTime == std::chrono::steady_clock::time_point()) {
+        return -1;
+    }
+    // Capture time of a mismatched clock may lie in the future
+    double age = std::max(std::chrono::duration<double, std::milli>(now - captureTime).count(), 0.0);
+    latencyHistograms[stage].add(age);
+    return age;
+}
+
+// MARK: - Out functions
+
+void BrainWorker::getLatencyHistogram(LatencyStage stage, uint64_t counts[LatencyHistogram::numberOfBuckets])
+{
+    if (stage >= 0 && stage < LatencyStageCount) {
+        latencyHistograms[stage].getCounts(counts);
+    }
+}
+
+void BrainWorker::resetLatencyHistograms()
+{
+    for (LatencyHistogram &histogram : latencyHistograms) {
+        histogram.reset();
+    }
+}
+
+SimulationOutput BrainWorker::getOutputs()
+{
+    std::lock_guard<std::mutex> lock(outputsReadMutex);
+    outputs.update();
+    return outputs.readBuffer();
+}
+
+double BrainWorker::getLeftTorque()
+{
+    std::lock_guard<std::mutex> lock(outputsReadMutex);
+    outputs.update();
+    return outputs.readBuffer().leftTorque;
+}
+
+double BrainWorker::getRightTorque()
+{
+    std::lock_guard<std::mutex> lock(outputsReadMutex);
+    outputs.update();
+    return outputs.readBuffer().rightTorque;
+}
+
+float BrainWorker::getSpeakerTone()
+{
+    std::lock_guard<std::mutex> lock(outputsReadMutex);
+    outputs.update();
+    return outputs.readBuffer().speakerTone;
+}
+
+std::vector<double> BrainWorker::getNeuronValues()
+{
+    std::lock_guard<std::mutex> lock(outputsReadMutex);
+    outputs.update();
+    return outputs.readBuffer().neuronValues;
 }
 
 std::vector<std::vector<double>> BrainWorker::getConnectToMe()
@@ -543,15 +1317,9 @@ std::vector<double> BrainWorker::getY()
 
 std::vector<bool> BrainWorker::getFiringNeurons()
 {
-    auto numberOfNeurons = brain.neurons.size();
-    std::vector<bool> neuronValues(numberOfNeurons);
-    
-    for (int i = 0; i < numberOfNeurons; i++) {
-        auto neuron = brain.neurons[i];
-        neuronValues[i] = neuron.firing;
-    }
-    
-    return neuronValues;
+    std::lock_guard<std::mutex> lock(outputsReadMutex);
+    outputs.update();
+    return outputs.readBuffer().firingNeurons;
 }
 
 std::vector<std::vector<double>> BrainWorker::getColors()
@@ -11,6 +11,11 @@
 
 #include <iostream>
 #include <vector>
+#include <memory>
+#include <random>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <opencv2/opencv.hpp>
 
 #include "Models/Brain.hpp"
@@ -19,7 +24,23 @@
 #include "Models/CameraType.hpp"
 #include "Models/AudioSpectrum.hpp"
 #include "Models/ColorSpace.h"
+#include "Models/CatchUpPolicy.hpp"
+#include "Models/SimulationOutput.hpp"
+#include "Models/VisionOutput.hpp"
+#include "Models/VideoFrame.hpp"
+#include "Models/EyeFrames.hpp"
+#include "Models/EyeRegion.hpp"
+#include "Models/AudioFrame.hpp"
+#include "Models/LatencyStage.hpp"
 #include "Core/Semaphore.h"
+#include "Core/TripleBuffer.hpp"
+#include "Core/QualityGovernor.hpp"
+#include "Core/LatencyHistogram.hpp"
+#include "Sharding/SpikeExchange.hpp"
+#include "Compiler/BrainCompiler.hpp"
+#include "Vision/ColorClassifier.hpp"
+#include "Vision/Eye.hpp"
+#include "Vision/FeatureExtractor.hpp"
 
 class BrainWorker {
     
@@ -27,6 +48,7 @@ private:
     
     Brain brain;
     Semaphore semaphore;
+    std::thread simulationThread;
     
     /// Settings data
     static const int rowsResized = 227;
@@ -38,12 +60,140 @@ private:
     // Audio spectrum data
     AudioSpectrum spectrum;
     
+    /// Audio mailbox, written by microphone thread
+    TripleBuffer<AudioFrame> audioFrames;
+    
+    /// Capture times of inputs used by simulation, owned by simulation thread
+    std::chrono::steady_clock::time_point videoCaptureTime;
+    std::chrono::steady_clock::time_point featureCaptureTime;
+    std::chrono::steady_clock::time_point audioCaptureTime;
+    std::chrono::steady_clock::time_point distanceInUseTime;
+    std::atomic<std::chrono::steady_clock::rep> distanceCaptureTime { 0 };
+    
+    /// Latencies indexed by `LatencyStage`
+    LatencyHistogram latencyHistograms[LatencyStageCount];
+    
+    /// OUT data, owned by simulation thread
+    double leftTorque = 0;
+    double rightTorque = 0;
+    float speakerTone = 0;
+    
+    /// Vision pipelines, one per region of eye layout
+    std::vector<std::unique_ptr<Eye>> eyes;
+    std::vector<EyeRegion> eyeLayout;
+    std::vector<EyeRegion> defaultLayout;
+    
+    /// Video frames mailboxes indexed by source, written by camera threads
+    static const int maxNumberOfSources = 4;
+    TripleBuffer<VideoFrame> videoFrames[maxNumberOfSources];
+    std::atomic<uint64_t> videoSequenceNumber { 0 };
+    
+    /// Vision stage, runs on its own thread and is woken up by every submitted frame
+    std::thread visionThread;
+    Semaphore frameSemaphore;
+    TripleBuffer<VisionOutput> visionOutputs;
+    std::atomic<double> visionStaleness { -1 };
+    std::atomic<bool> blobTracking { false };
+    std::atomic<bool> fluidVision { false };
+    bool motionVision = false;
+    std::atomic<double> frameChangeThreshold { 0 };
+    std::atomic<double> visionLoad { 0 };
+    int eyeSize = rowsResized;
+    
+    /// Feature extraction stage, runs on its own thread and is woken up by every processed frame
+    std::shared_ptr<FeatureExtractor> featureExtractor;
+    std::atomic<double> featureBudget { 0 };
+    std::thread featureThread;
+    Semaphore eyeFramesSemaphore;
+    TripleBuffer<EyeFrames> eyeFrames;
+    TripleBuffer<VisionOutput> featureOutputs;
+    
+    /// Published OUT data
+    TripleBuffer<SimulationOutput> outputs;
+    std::mutex outputsReadMutex;
+    uint64_t generation = 0;
+    
+    /// Timing data
+    std::atomic<int> catchUpPolicy { CatchUpPolicyNone };
+    std::atomic<int> maxBurst { 4 };
+    std::atomic<double> lag { 0 };
+    
+    /// Quality of sensory processing, governor is owned by simulation thread
+    QualityGovernor qualityGovernor;
+    std::atomic<bool> qualityGovernorEnabled { false };
+    std::atomic<int> qualityLevel { 0 };
+    std::vector<float> decimatedAudio;
+    
+    /// Sharding data
+    std::shared_ptr<SpikeExchange> spikeExchange;
+    long exchangeStep = 0;
+    std::vector<int> localSpikes;
+    std::vector<int> allSpikes;
+    
+    /// Compiled brain data
+    BrainCompiler compiler;
+    std::vector<double> kernelV;
+    std::vector<double> kernelU;
+    std::vector<double> kernelSensoryI;
+    std::vector<double> kernelNoise;
+    std::vector<double> kernelIStep;
+    std::vector<uint8_t> kernelSpikes;
+    
     /// Simulation functions
     void simulateNextIteration();
     void updateBrain();
-    void processVisualInput();
+    void runCompiledBrain(std::mt19937 &gen, std::normal_distribution<double> &distribution);
+    void runVision();
+    void runFeatureExtraction();
+    void publishEyeFrames(uint64_t frameNumber, std::chrono::steady_clock::time_point timestamp, std::chrono::steady_clock::time_point captureTime);
+    void copyVisPrefVals(const VisionOutput &output, size_t firstRow);
+    size_t numberOfVisionRows();
+    void updateVisualInput();
+    void processEye(Eye &eye, CameraType camera, ColorSpace frameColorSpace, const cv::Mat *planes, const cv::Rect *cuts, int numberOfPlanes);
     void processAudioInput();
     void updateMotors();
+    void publishOutputs();
+    
+    /// Returns age of input in ms and adds it to histogram of stage.
+    /// @return -1 if there was no input yet
+    double inputAge(std::chrono::steady_clock::time_point captureTime, std::chrono::steady_clock::time_point now, LatencyStage stage);
+    size_t videoFrameSize();
+    void publishVideoFrame(int source, int width, int height);
+    
+    /// Submits planes of frame of given size to source, see `submitVideoPlanes`.
+    int submitFrame(const uint8_t *const *planes, const size_t *bytesPerRow, int numberOfPlanes, ColorSpace format, int width, int height,
+                    VideoFrameRelease release, void *context, int source, std::chrono::steady_clock::time_point captureTime);
+    
+    /// Gives frames which vision read in place back to their owners.
+    void releaseVideoFrames();
+    
+    /// Waits for simulation, vision and feature threads to exit, once `isRunning` is cleared.
+    void joinThreads();
+    
+    /// Returns eye layout which is used for the current video size.
+    const std::vector<EyeRegion> & currentEyeLayout();
+    
+    /// Returns number of bytes of rows of each plane without padding.
+    /// @return Number of planes
+    static int packedPlanes(ColorSpace format, int width, size_t bytesPerRow[VideoFrame::maxNumberOfPlanes]);
+    
+    /// Finds planes of frame whose chroma planes follow luma, see `submitVideo`.
+    /// @return Number of planes
+    static int contiguousPlanes(const uint8_t *frame, size_t bytesPerRow, ColorSpace format, int width, int height,
+                                const uint8_t *planes[VideoFrame::maxNumberOfPlanes], size_t planeBytesPerRow[VideoFrame::maxNumberOfPlanes]);
+    
+    /// Wraps planes of video frame without copying, each from its own first row and row stride.
+    /// @return Number of wrapped planes, Bayer frames give two planes of quads
+    static int videoPlanes(const uint8_t *const *framePlanes, const size_t *bytesPerRow, ColorSpace format, int width, int height,
+                           cv::Mat planes[Eye::maxNumberOfPlanes]);
+    
+    /// Returns number of bytes per pixel of the first plane.
+    static int bytesPerPixel(ColorSpace format);
+    static bool isBayer(ColorSpace format);
+    
+    /// Runs missed neural loops without sensory processing.
+    /// @return Number of loops run
+    int runBurst(int numberOfLoops);
     
 public:
 
@@ -52,16 +202,8 @@ public:
     int cols = 1920;
     int rows = 1080;
     int distance = 4000;
-    uint8_t *videoFrame = NULL;
-    std::vector<float> audioData;
-    int audioSampleRate = 0;
     ColorSpace colorSpace;
     
-    /// OUT data
-    double leftTorque = 0;
-    double rightTorque = 0;
-    float speakerTone = 0;
-    
     /// Other data
     bool isRunning = false;
     bool whileLoopIsRunning = false;
@@ -73,7 +215,7 @@ public:
     /// Starts brain.
     void start();
     
-    /// Stops brain.
+    /// Stops brain and waits for its threads to exit.
     void stop();
     
     /// Set video size parameters.
@@ -81,24 +223,205 @@ public:
     /// @param height_ Height of video
     void setVideoSize(int width_, int height_);
     
+    /// Submits video frame, it's copied so the caller can reuse its buffer.
+    /// Never blocks, frames which vision doesn't take in time are dropped.
+    /// Has to be called from one thread at a time for each source.
+    /// @param frame Video frame of size set by `setVideoSize`, 3 bytes per pixel for RGB, 4 for BGRA, 1.5 for NV12 and I420 and 1 for Bayer
+    /// @param source Index of camera which took the frame, see `setEyeLayout`
+    /// @param captureTime When camera captured the frame, default is the time of the call
+    void setVideo(const uint8_t *frame, int source = 0, std::chrono::steady_clock::time_point captureTime = std::chrono::steady_clock::time_point());
+    
+    /// Submits video frame which may have padded rows and is read in place if it has an owner.
+    /// Never blocks, frames which vision doesn't take in time are dropped.
+    /// Has to be called from one thread at a time for each source.
+    /// @param frame Video frame of size set by `setVideoSize`, chroma planes of NV12 and I420 follow luma and their rows
+    /// are padded in the same way, so their rows are `bytesPerRow` and half of it apart respectively.
+    /// Frames whose planes aren't laid out like this are submitted with `submitVideoPlanes`.
+    /// Bayer frames are classified by 2x2 quads, so eyes see them in half resolution.
+    /// @param bytesPerRow Number of bytes between starts of luma rows
+    /// @param format Color space of frame, see `ColorSpace.h`
+    /// @param release Called once vision is done with the frame or dropped it, from vision or this thread.
+    /// NULL copies the frame, so the caller can reuse its buffer.
+    /// @param context Passed to `release`
+    /// @param source Index of camera which took the frame, see `setEyeLayout`
+    /// @param captureTime When camera captured the frame, default is the time of the call
+    /// @return Non zero value indicates to occurred error, frame is released right away in that case
+    int submitVideo(const uint8_t *frame, size_t bytesPerRow, ColorSpace format, VideoFrameRelease release, void *context, int source = 0,
+                    std::chrono::steady_clock::time_point captureTime = std::chrono::steady_clock::time_point());
+    
+    /// Submits video frame whose planes are separate buffers, e.g. planes of Android `AImage` or iOS `CVPixelBuffer`.
+    /// It's submitted like `submitVideo`, only the planes are given one by one.
+    /// @param planes First row of each plane, luma and interleaved chroma of NV12, luma, U and V of I420, the only plane of other color spaces
+    /// @param bytesPerRow Number of bytes between starts of rows of each plane
+    /// @param numberOfPlanes Number of elements of `planes` and `bytesPerRow`
+    /// @param chromaPixelStride Number of bytes between chroma samples of one channel, 2 for NV12 and 1 for I420.
+    /// I420 with 2 is accepted if V follows U in the same rows, it's read as NV12 then. It's ignored for other color spaces.
+    /// @param format Color space of frame, see `ColorSpace.h`
+    /// @param release Called once vision is done with the frame or dropped it, NULL copies the frame
+    /// @param context Passed to `release`
+    /// @param source Index of camera which took the frame, see `setEyeLayout`
+    /// @param captureTime When camera captured the frame, default is the time of the call
+    /// @return Non zero value indicates to occurred error, frame is released right away in that case
+    int submitVideoPlanes(const uint8_t *const *planes, const size_t *bytesPerRow, int numberOfPlanes, int chromaPixelStride, ColorSpace format,
+                          VideoFrameRelease release, void *context, int source = 0,
+                          std::chrono::steady_clock::time_point captureTime = std::chrono::steady_clock::time_point());
+    
+    /// Submits image of one eye which camera cropped and scaled already, so vision skips cropping and resizing
+    /// if it has the eye size of the current quality level, see `setPreCroppedEyes`. It's submitted like `submitVideo`.
+    /// @param eye Index of eye, eyes use sources of the same index
+    /// @param frame Eye image of any size, chroma planes of NV12 and I420 follow luma
+    /// @param width Width of image
+    /// @param height Height of image, images which aren't square are stretched
+    /// @param bytesPerRow Number of bytes between starts of luma rows
+    /// @param format Color space of image, see `ColorSpace.h`
+    /// @param release Called once vision is done with the image or dropped it, NULL copies the image
+    /// @param context Passed to `release`
+    /// @param captureTime When camera captured the image, default is the time of the call
+    /// @return Non zero value indicates to occurred error, image is released right away in that case
+    int submitEyeFrame(int eye, const uint8_t *frame, int width, int height, size_t bytesPerRow, ColorSpace format, VideoFrameRelease release,
+                       void *context, std::chrono::steady_clock::time_point captureTime = std::chrono::steady_clock::time_point());
+    
+    /// Submits audio buffer, it's copied. Never blocks, buffers which simulation doesn't take in time are dropped.
+    /// Has to be called from one thread at a time.
+    /// @param samples Audio samples
+    /// @param numberOfSamples Number of samples
+    /// @param sampleRate Sample rate in Hz
+    /// @param captureTime When microphone captured the buffer, default is the time of the call
+    void setAudio(const float *samples, int numberOfSamples, int sampleRate, std::chrono::steady_clock::time_point captureTime = std::chrono::steady_clock::time_point());
+    
+    /// Set distance sensor reading.
+    /// @param distance_ Distance
+    /// @param captureTime When the distance was measured, default is the time of the call
+    void setDistance(int distance_, std::chrono::steady_clock::time_point captureTime = std::chrono::steady_clock::time_point());
+    
+    /// Set regions of video frames seen by eyes, scores of eye at index `i` are in column `i` of visual preference values.
+    /// All eyes are processed as one batch. Eyes of sources without a new frame reuse their last copied frame,
+    /// or keep their scores if it was read in place and released already, see `submitVideo`.
+    /// Default layout are two square crops at the left and right frame edges of source 0. Has to be called before `start`.
+    /// @param layout Eye regions, parts outside of frames are ignored, empty restores the default layout. Cameras have to be left or right.
+    /// @return Non zero value indicates to occurred error
+    int setEyeLayout(const std::vector<EyeRegion> &layout);
+    
+    /// Set layout of eyes whose images are submitted with `submitEyeFrame`, even eyes are left and odd are right.
+    /// Has to be called before `start`.
+    /// @param numberOfEyes Number of eyes, at most the number of sources
+    /// @return Non zero value indicates to occurred error
+    int setPreCroppedEyes(int numberOfEyes);
+    
     /// Set video color space
     /// @param colorSpace_ Color space of video frames, see `ColorSpace.h`
     void setColorSpace(ColorSpace colorSpace_);
     
+    /// Set what happens when simulation falls behind wall-clock.
+    /// @param policy_ Catch-up policy, see `CatchUpPolicy.hpp`
+    /// @param maxBurst_ Max number of consecutive loops run to catch up (skipped sensors or neural loops in a burst),
+    /// lag which is left after that is declared
+    void setCatchUpPolicy(CatchUpPolicy policy_, int maxBurst_);
+    
+    /// Returns by how many ms neural time is behind wall-clock since start.
+    double getLag();
+    
+    /// Set how much an eye's crop of camera frame has to change to be processed again, see `FrameSignature`.
+    /// Scores of eyes which changed less are reused.
+    /// @param threshold Mean absolute difference of sampled pixel channels, 0 processes every frame. Default is 0, 1 skips only still scenes.
+    void setFrameChangeThreshold(double threshold);
+    
+    /// Set extractor of visual features, rows of visual preference values which follow motion rows are set to them.
+    /// Features of frames are extracted on a separate thread, frames which arrive meanwhile are dropped.
+    /// Has to be called before `start`.
+    /// @param extractor Feature extractor, see `DnnFeatureExtractor`, NULL to stop extracting features
+    /// @param budget Max average ms of extraction per frame, frames are skipped after slower extractions, 0 for no limit
+    /// @return Non zero value indicates to occurred error
+    int setFeatureExtractor(std::shared_ptr<FeatureExtractor> extractor, double budget);
+    
+    /// Set whether eye crop, resize and color classification run as a G-API Fluid graph, see `FluidEyePipeline`.
+    /// Native stages are used for color spaces the graph doesn't support, if it fails to compile or while features are
+    /// extracted, since they need eye frames.
+    void setFluidVision(bool enabled);
+    
+    /// Set whether vision measures motion energy of eyes, see `MotionDetector`.
+    /// Rows of motion scores of horizontal bands from top to bottom follow color rows of visual preference values,
+    /// they are zero while it's disabled, so rows of features follow them at the same position either way.
+    /// Eye crop and resize don't run as a Fluid graph while it's enabled.
+    /// Has to be called before `start`.
+    void setMotionVision(bool enabled);
+    
+    /// Set whether quality of sensory processing is lowered while loops run out of time, see `QualityGovernor`.
+    /// Eye resolution drops from 227 to 113 and 57 pixels, then audio is decimated and vision frames are skipped.
+    /// Blob scores are rescaled to full resolution. Eye resolution stays full while features are extracted.
+    /// Disabling returns to full quality with the next loop, enabling again starts at full quality.
+    void setQualityGovernor(bool enabled);
+    
+    /// Returns current level of `QualityGovernor`, 0 is full quality.
+    int getQualityLevel();
+    
+    /// Set whether vision searches for blobs around their positions in the previous frame, see `BlobDetector`.
+    /// Saves most of labeling work while blobs move slowly, scores of a newly appeared bigger blob may be delayed
+    /// by a few frames.
+    void setBlobTracking(bool enabled);
+    
+    /// Returns how many ms old was the camera frame when the last loop used visual input computed from it.
+    /// @return -1 if no frame was processed yet
+    double getVisionStaleness();
+    
     /// Loads and parse brain file.
     /// @param filePath Path to the *.mat file
     /// @return Non zero value indicates to occurred error
     int load(std::string filePath);
     
-    /// Calculates score for video input based on selected color.
-    /// @param color Red, green or blue color
-    /// @param frame Video frame
+    /// Runs only a range of neurons in this process, spikes of other shards are received through `exchange`.
+    /// Every shard has to load the same brain file. Has to be called after `load` and before `start`.
+    /// Pass NULL to run the whole brain again.
+    /// @param exchange Transport shared with other shards
+    void setSpikeExchange(std::shared_ptr<SpikeExchange> exchange);
+    
+    /// Compiles loaded brain into specialized kernel and uses it instead of generic simulation.
+    /// Kernels are cached by content hash, so the same brain is compiled only once. Not supported on iOS.
+    /// Has to be called after `load` and before `start`, it's ignored while the brain runs as a shard.
+    /// @param cacheDirectory Existing directory where compiled brains are kept
+    /// @return Non zero value indicates to occurred error, generic simulation is used in that case
+    int compile(std::string cacheDirectory);
+    
+    /// Returns number of neurons of loaded brain.
+    int getNumberOfNeurons();
+    
+    /// Processes the newest submitted video frame on the calling thread, vision thread calls it for every frame.
+    /// Used directly only to measure vision while brain isn't started.
+    void processVisualInput();
+    
+    /// Returns visual preference values of the newest frame processed by `processVisualInput`, same layout as `Brain::visPrefVals`.
+    /// Takes them from simulation, so it's used only while brain isn't started.
+    std::vector<std::vector<double>> getVisionOutput();
+    
+    /// Calculates score for video input based on the largest blob of color mask.
+    /// @param blob Largest blob of color mask, see `BlobDetector`
     /// @param camera Left or right camera
-    Score calculateScore(ColorType color, cv::Mat frame, CameraType camera);
+    Score calculateScore(const Blob &blob, CameraType camera);
     
 // MARK: - Out functions
     
+    /// Returns outputs of the last completed loop. Never blocks simulation.
+    SimulationOutput getOutputs();
+    
+    /// Copies histogram of latencies since start or the last reset, see `LatencyHistogram::bucketLimits`.
+    /// @param stage Measured stage
+    /// @param counts Output with `LatencyHistogram::numberOfBuckets` elements
+    void getLatencyHistogram(LatencyStage stage, uint64_t counts[LatencyHistogram::numberOfBuckets]);
+    
+    void resetLatencyHistograms();
+    
+    /// Returns left torque of the last completed loop.
+    double getLeftTorque();
+    
+    /// Returns right torque of the last completed loop.
+    double getRightTorque();
+    
+    /// Returns speaker tone of the last completed loop.
+    float getSpeakerTone();
+    
     /// Returns neuron `v` values.
+    /// While brain runs as a shard, only neurons of this shard are simulated, others keep values they had at `start`.
+    /// Their firing is taken from exchanged spikes, see `getFiringNeurons`.
     std::vector<double> getNeuronValues();
     
     /// Returns `connectome` values of neurons.
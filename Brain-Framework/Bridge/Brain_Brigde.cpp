@@ -10,12 +10,30 @@
 #include "../BrainWorker.hpp"
 #include "../AudioProcessing.cpp"
 #include "../Models/ColorSpace.h"
+#include "../Sharding/SharedMemorySpikeExchange.hpp"
+#include "../Vision/DnnFeatureExtractor.hpp"
 #include <thread>
 
+/// Converts capture time in ns of `std::chrono::steady_clock`, see `brain_now`. 0 stands for the time of submission.
+static std::chrono::steady_clock::time_point captureTime(uint64_t nanoseconds)
+{
+    if (nanoseconds == 0) {
+        return std::chrono::steady_clock::time_point();
+    }
+    auto sinceEpoch = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(nanoseconds));
+    return std::chrono::steady_clock::time_point(sinceEpoch);
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+const uint64_t brain_now(void)
+{
+    auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count();
+}
+
 const void* brain_Init(int colorSpace)
 {
     BrainWorker* brain = new BrainWorker();
@@ -35,6 +53,27 @@ const int brain_load(const void* object, char* pathToMatFile_)
     return brainObject->load(std::string(pathToMatFile_));
 }
 
+const int brain_setShard(const void* object, const char* sharedMemoryName, int shardIndex, int numberOfShards, uint64_t session)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    if (numberOfShards <= 1) {
+        brainObject->setSpikeExchange(NULL);
+        return 0;
+    }
+    
+    int numberOfNeurons = brainObject->getNumberOfNeurons();
+    int capacity = (numberOfNeurons + numberOfShards - 1) / numberOfShards;
+    
+    auto exchange = std::make_shared<SharedMemorySpikeExchange>();
+    int error = exchange->open(std::string(sharedMemoryName), shardIndex, numberOfShards, capacity, session);
+    if (error != 0) {
+        return error;
+    }
+    
+    brainObject->setSpikeExchange(exchange);
+    return 0;
+}
+
 const void brain_start(const void* object)
 {
     BrainWorker* brainObject = (BrainWorker*)object;
@@ -57,41 +96,211 @@ const void brain_deinit(const void* object)
     delete brainObject;
 }
 
+const void brain_setCatchUpPolicy(const void* object, int policy, int maxBurst)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    brainObject->setCatchUpPolicy(CatchUpPolicy(policy), maxBurst);
+}
+
+const double brain_getLag(const void* object)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    return brainObject->getLag();
+}
+
+const double brain_getVisionStaleness(const void* object)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    return brainObject->getVisionStaleness();
+}
+
+const void brain_setBlobTracking(const void* object, int enabled)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    brainObject->setBlobTracking(enabled != 0);
+}
+
+const void brain_setFrameChangeThreshold(const void* object, double threshold)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    brainObject->setFrameChangeThreshold(threshold);
+}
+
+const void brain_setFluidVision(const void* object, int enabled)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    brainObject->setFluidVision(enabled != 0);
+}
+
+const void brain_setMotionVision(const void* object, int enabled)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    brainObject->setMotionVision(enabled != 0);
+}
+
+const void brain_setQualityGovernor(const void* object, int enabled)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    brainObject->setQualityGovernor(enabled != 0);
+}
+
+const int brain_getQualityLevel(const void* object)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    return brainObject->getQualityLevel();
+}
+
+const int brain_loadFeatureExtractor(const void* object, const char* modelPath, const char* configPath, const int* outputIndices, int numberOfOutputs, double activationScale, double budget)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    
+    std::shared_ptr<DnnFeatureExtractor> extractor = std::make_shared<DnnFeatureExtractor>();
+    std::vector<int> indices(outputIndices, outputIndices + numberOfOutputs);
+    int error = extractor->load(modelPath, configPath ? configPath : "", indices, activationScale);
+    if (error) {
+        return error;
+    }
+    return brainObject->setFeatureExtractor(extractor, budget);
+}
+
 const void brain_setDistance(const void* object, int distance)
 {
     BrainWorker* brainObject = (BrainWorker*)object;
-    brainObject->distance = distance;
+    brainObject->setDistance(distance);
+}
+
+const void brain_setTimedDistance(const void* object, int distance, uint64_t captureTimeNs)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    brainObject->setDistance(distance, captureTime(captureTimeNs));
 }
 
 const void brain_setVideo(const void* object, const uint8_t* videoFrame)
 {
     BrainWorker* brainObject = (BrainWorker*)object;
-    memcpy(brainObject->videoFrame, videoFrame, brainObject->cols * brainObject->rows * 3);
+    brainObject->setVideo(videoFrame);
+}
+
+const void brain_setVideoOfSource(const void* object, const uint8_t* videoFrame, int source)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    brainObject->setVideo(videoFrame, source);
+}
+
+const int brain_submitVideo(const void* object, const uint8_t* videoFrame, size_t bytesPerRow, int colorSpace, void (*release)(void* context), void* context, int source, uint64_t captureTimeNs)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    return brainObject->submitVideo(videoFrame, bytesPerRow, ColorSpace(colorSpace), release, context, source, captureTime(captureTimeNs));
+}
+
+const int brain_submitVideoPlanes(const void* object, int numberOfPlanes, const uint8_t* const* planes, const size_t* bytesPerRow, int chromaPixelStride, int colorSpace, void (*release)(void* context), void* context, int source, uint64_t captureTimeNs)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    return brainObject->submitVideoPlanes(planes, bytesPerRow, numberOfPlanes, chromaPixelStride, ColorSpace(colorSpace), release, context, source, captureTime(captureTimeNs));
+}
+
+const int brain_setEyeLayout(const void* object, int numberOfEyes, const int* sources, const int* rectangles, const int* cameras)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    
+    std::vector<EyeRegion> layout(std::max(numberOfEyes, 0));
+    for (int i = 0; i < numberOfEyes; i++) {
+        layout[i].source = sources[i];
+        layout[i].rect = cv::Rect(rectangles[i * 4], rectangles[i * 4 + 1], rectangles[i * 4 + 2], rectangles[i * 4 + 3]);
+        layout[i].camera = CameraType(cameras[i]);
+    }
+    return brainObject->setEyeLayout(layout);
+}
+
+const int brain_setPreCroppedEyes(const void* object, int numberOfEyes)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    return brainObject->setPreCroppedEyes(numberOfEyes);
+}
+
+const int brain_submitEyeFrame(const void* object, int eye, const uint8_t* eyeFrame, int width, int height, size_t bytesPerRow, int colorSpace, void (*release)(void* context), void* context, uint64_t captureTimeNs)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    return brainObject->submitEyeFrame(eye, eyeFrame, width, height, bytesPerRow, ColorSpace(colorSpace), release, context, captureTime(captureTimeNs));
 }
 
 const void brain_setAudio(const void* object, const float* audioData, const int numberOfSamples, const int sampleRate)
 {
     BrainWorker* brainObject = (BrainWorker*)object;
-    brainObject->audioSampleRate = sampleRate;
-    brainObject->audioData = std::vector<float>(audioData, audioData + numberOfSamples);
+    brainObject->setAudio(audioData, numberOfSamples, sampleRate);
+}
+
+const void brain_setTimedAudio(const void* object, const float* audioData, const int numberOfSamples, const int sampleRate, uint64_t captureTimeNs)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    brainObject->setAudio(audioData, numberOfSamples, sampleRate, captureTime(captureTimeNs));
 }
 
 const double brain_getRightTorque(const void* object)
 {
     BrainWorker* brainObject = (BrainWorker*)object;
-    return brainObject->rightTorque;
+    return brainObject->getRightTorque();
 }
 
 const double brain_getLeftTorque(const void* object)
 {
     BrainWorker* brainObject = (BrainWorker*)object;
-    return brainObject->leftTorque;
+    return brainObject->getLeftTorque();
 }
 
 const float brain_getSpeakerTone(const void* object)
 {
     BrainWorker* brainObject = (BrainWorker*)object;
-    return brainObject->speakerTone;
+    return brainObject->getSpeakerTone();
+}
+
+const void brain_getOutputs(const void* object, double *leftTorque, double *rightTorque, float *speakerTone, uint64_t *generation)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    
+    auto outputs = brainObject->getOutputs();
+    
+    *leftTorque = outputs.leftTorque;
+    *rightTorque = outputs.rightTorque;
+    *speakerTone = outputs.speakerTone;
+    *generation = outputs.generation;
+}
+
+const void brain_getTimedOutputs(const void* object, double *leftTorque, double *rightTorque, float *speakerTone, uint64_t *generation, double *videoAge, double *featureAge, double *audioAge, double *distanceAge)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    
+    auto outputs = brainObject->getOutputs();
+    
+    *leftTorque = outputs.leftTorque;
+    *rightTorque = outputs.rightTorque;
+    *speakerTone = outputs.speakerTone;
+    *generation = outputs.generation;
+    *videoAge = outputs.videoAge;
+    *featureAge = outputs.featureAge;
+    *audioAge = outputs.audioAge;
+    *distanceAge = outputs.distanceAge;
+}
+
+const int brain_getLatencyHistogram(const void* object, int stage, uint64_t *counts, double *bucketLimits, int capacity)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    
+    uint64_t allCounts[LatencyHistogram::numberOfBuckets] = {};
+    brainObject->getLatencyHistogram(LatencyStage(stage), allCounts);
+    
+    int numberOfBuckets = std::min(capacity, LatencyHistogram::numberOfBuckets);
+    for (int i = 0; i < numberOfBuckets; i++) {
+        counts[i] = allCounts[i];
+        bucketLimits[i] = LatencyHistogram::bucketLimits[i];
+    }
+    return numberOfBuckets;
+}
+
+const void brain_resetLatencyHistograms(const void* object)
+{
+    BrainWorker* brainObject = (BrainWorker*)object;
+    brainObject->resetLatencyHistograms();
 }
 
 const double* brain_getNeuronValues(const void* object, size_t *numberOfNeurons)
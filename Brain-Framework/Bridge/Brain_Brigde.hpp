@@ -20,14 +20,50 @@ extern "C" {
 const void* brain_Init(int colorSpace);
 const void brain_setVideoSize(const void* object, int width_, int height_);
 const int brain_load(const void* object, char* pathToMatFile_);
+// Session has to be the same for all shards of a run and differ between runs, e.g. launcher's pid or start time
+const int brain_setShard(const void* object, const char* sharedMemoryName, int shardIndex, int numberOfShards, uint64_t session);
 const void brain_start(const void* object);
 const void brain_stop(const void* object);
+// See CatchUpPolicy.hpp
+const void brain_setCatchUpPolicy(const void* object, int policy, int maxBurst);
+const double brain_getLag(const void* object);
+const double brain_getVisionStaleness(const void* object);
+const void brain_setBlobTracking(const void* object, int enabled);
+const void brain_setFrameChangeThreshold(const void* object, double threshold);
+const void brain_setFluidVision(const void* object, int enabled);
+const void brain_setMotionVision(const void* object, int enabled);
+const void brain_setQualityGovernor(const void* object, int enabled);
+const int brain_getQualityLevel(const void* object);
+// Extractor can be changed only while brain isn't running
+const int brain_loadFeatureExtractor(const void* object, const char* modelPath, const char* configPath, const int* outputIndices, int numberOfOutputs, double activationScale, double budget);
+// Capture times are in ns of the clock of brain_now, 0 stands for the time of the call. Camera and sensor timestamps of
+// other clocks (mach ticks, CLOCK_MONOTONIC, CLOCK_BOOTTIME) are converted by their age: brain_now() - (sensor now - timestamp)
+const uint64_t brain_now(void);
 const void brain_setDistance(const void* object, int distance);
+const void brain_setTimedDistance(const void* object, int distance, uint64_t captureTimeNs);
 const void brain_setVideo(const void* object, const uint8_t* videoFrame);
+const void brain_setVideoOfSource(const void* object, const uint8_t* videoFrame, int source);
+// Frame is read in place until release is called, NULL release copies it. Color space see ColorSpace.h
+const int brain_submitVideo(const void* object, const uint8_t* videoFrame, size_t bytesPerRow, int colorSpace, void (*release)(void* context), void* context, int source, uint64_t captureTimeNs);
+// Planes in separate buffers, e.g. of AImage, chroma pixel stride 2 of I420 is read as NV12 if V follows U
+const int brain_submitVideoPlanes(const void* object, int numberOfPlanes, const uint8_t* const* planes, const size_t* bytesPerRow, int chromaPixelStride, int colorSpace, void (*release)(void* context), void* context, int source, uint64_t captureTimeNs);
+// Eye rectangles are given as x, y, width and height, all zero is the whole frame, cameras see CameraType.hpp
+const int brain_setEyeLayout(const void* object, int numberOfEyes, const int* sources, const int* rectangles, const int* cameras);
+// Eye images scaled by camera skip cropping and resizing, even eyes are left and odd are right
+const int brain_setPreCroppedEyes(const void* object, int numberOfEyes);
+const int brain_submitEyeFrame(const void* object, int eye, const uint8_t* eyeFrame, int width, int height, size_t bytesPerRow, int colorSpace, void (*release)(void* context), void* context, uint64_t captureTimeNs);
 const void brain_setAudio(const void* object, const float* audioData, const int numberOfSamples, const int sampleRate);
+const void brain_setTimedAudio(const void* object, const float* audioData, const int numberOfSamples, const int sampleRate, uint64_t captureTimeNs);
 const double brain_getRightTorque(const void* object);
 const double brain_getLeftTorque(const void* object);
 const float brain_getSpeakerTone(const void* object);
+const void brain_getOutputs(const void* object, double *leftTorque, double *rightTorque, float *speakerTone, uint64_t *generation);
+// Ages of inputs behind outputs in ms, -1 if there was no input yet
+const void brain_getTimedOutputs(const void* object, double *leftTorque, double *rightTorque, float *speakerTone, uint64_t *generation, double *videoAge, double *featureAge, double *audioAge, double *distanceAge);
+// See LatencyStage.hpp, returns number of copied buckets, the last bucket has infinite limit
+const int brain_getLatencyHistogram(const void* object, int stage, uint64_t *counts, double *bucketLimits, int capacity);
+const void brain_resetLatencyHistograms(const void* object);
+// Shards simulate v of their own neurons only, firing of all neurons is exchanged
 const double* brain_getNeuronValues(const void* object, size_t *numberOfNeurons);
 const bool* brain_getFiringNeurons(const void* object, size_t *numberOfNeurons);
 const void brain_deinit(const void* object);
@@ -0,0 +1,272 @@
+//
+//  BrainCompiler.cpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "BrainCompiler.hpp"
+
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+
+#ifdef __APPLE__
+    #include <TargetConditionals.h>
+#endif
+
+#if !(defined(__APPLE__) && TARGET_OS_IPHONE)
+    #include <dlfcn.h>
+    #include <spawn.h>
+    #include <unistd.h>
+    #include <sys/wait.h>
+    extern char **environ;
+    #define BRAIN_COMPILER_SUPPORTED 1
+#endif
+
+const char *BrainCompiler::kernelName = "brain_kernel";
+
+BrainCompiler::~BrainCompiler()
+{
+    unload();
+}
+
+std::string BrainCompiler::emit(Brain &brain)
+{
+    int n = (int)brain.neurons.size();
+    
+    std::ostringstream s;
+    s << std::setprecision(17);
+    
+    s << "// Generated by brainc, do not edit.\n";
+    s << "#include <stdint.h>\n";
+    s << "#include <math.h>\n\n";
+    s << "extern \"C\" void " << kernelName << "(double *v, double *u, const double *sensoryI, const double *noise, double *iStep, uint8_t *spikesStep, int numberOfSteps)\n";
+    s << "{\n";
+    
+    for (int i = 0; i < n; i++) {
+        s << "    double v" << i << " = v[" << i << "], u" << i << " = u[" << i << "], s" << i << " = sensoryI[" << i << "];\n";
+    }
+    
+    s << "\n    for (int t = 0; t < numberOfSteps; t++) {\n";
+    s << "        const double *noiseT = noise + t * " << n << ";\n";
+    s << "        double *iStepT = iStep + t * " << n << ";\n";
+    s << "        uint8_t *spikesT = spikesStep + t * " << n << ";\n\n";
+    
+    // Noise
+    for (int i = 0; i < n; i++) {
+        s << "        double I" << i << " = noiseT[" << i << "];\n";
+    }
+    
+    // Spikes and unrolled propagation of non zero weights
+    for (int i = 0; i < n; i++) {
+        Neuron & neuron = brain.neurons[i];
+        s << "        if (v" << i << " >= 30) {\n";
+        s << "            spikesT[" << i << "] = 1;\n";
+        s << "            v" << i << " = " << neuron.c << ";\n";
+        s << "            u" << i << " += " << neuron.d << ";\n";
+        for (int k = 0; k < n && k < (int)neuron.connectToMe.size(); k++) {
+            if (neuron.connectToMe[k] != 0) {
+                s << "            I" << k << " += " << neuron.connectToMe[k] << ";\n";
+            }
+        }
+        s << "        }\n";
+    }
+    
+    // Fused integration
+    for (int i = 0; i < n; i++) {
+        Neuron & neuron = brain.neurons[i];
+        s << "        I" << i << " += s" << i << ";\n";
+        s << "        iStepT[" << i << "] = I" << i << ";\n";
+        s << "        v" << i << " += 0.5 * (0.04 * (v" << i << " * v" << i << ") + 5 * v" << i << " + 140 - u" << i << " + I" << i << ");\n";
+        s << "        v" << i << " += 0.5 * (0.04 * (v" << i << " * v" << i << ") + 5 * v" << i << " + 140 - u" << i << " + I" << i << ");\n";
+        s << "        u" << i << " += " << neuron.a << " * (" << neuron.b << " * v" << i << " - u" << i << ");\n";
+        s << "        if (isnan(v" << i << ")) { v" << i << " = " << neuron.c << "; }\n";
+    }
+    
+    s << "    }\n\n";
+    
+    for (int i = 0; i < n; i++) {
+        s << "    v[" << i << "] = v" << i << "; u[" << i << "] = u" << i << ";\n";
+    }
+    
+    s << "}\n";
+    
+    return s.str();
+}
+
+uint64_t BrainCompiler::hash(const std::string &text)
+{
+    uint64_t value = 14695981039346656037ULL;
+    for (unsigned char c : text) {
+        value ^= c;
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
+
+#ifdef BRAIN_COMPILER_SUPPORTED
+/// Creates empty file with unique name next to given path, so concurrent compilations don't share it.
+/// @param path Path the file will be renamed to
+/// @param suffix Extension kept at the end of the name
+/// @param uniquePath Output, path of created file
+/// @return Non zero value indicates to occurred error
+static int createUniqueFile(const std::string &path, const std::string &suffix, std::string &uniquePath)
+{
+    std::vector<char> name(path.begin(), path.end());
+    std::string pattern = ".XXXXXX" + suffix;
+    name.insert(name.end(), pattern.begin(), pattern.end());
+    name.push_back('\0');
+    
+    int fd = mkstemps(name.data(), (int)suffix.size());
+    if (fd == -1) {
+        return -1;
+    }
+    close(fd);
+    uniquePath = name.data();
+    return 0;
+}
+
+/// Runs program without shell and waits for it.
+/// @param arguments Program and its arguments
+/// @return Non zero value indicates to occurred error, also if the program failed
+static int run(const std::vector<std::string> &arguments)
+{
+    std::vector<char *> argv;
+    for (const std::string &argument : arguments) {
+        argv.push_back((char *)argument.c_str());
+    }
+    argv.push_back(NULL);
+    
+    pid_t pid;
+    if (posix_spawnp(&pid, argv[0], NULL, NULL, argv.data(), environ) != 0) {
+        return -1;
+    }
+    
+    int status;
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR) {
+            return -1;
+        }
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
+#endif
+
+int BrainCompiler::compile(const std::string &source, std::string cacheDirectory, std::string &libraryPath)
+{
+#ifdef BRAIN_COMPILER_SUPPORTED
+    std::ostringstream name;
+    name << cacheDirectory << "/brain_" << std::hex << std::setw(16) << std::setfill('0') << hash(source);
+    
+    std::string sourcePath = name.str() + ".cpp";
+#ifdef __APPLE__
+    libraryPath = name.str() + ".dylib";
+#else
+    libraryPath = name.str() + ".so";
+#endif
+    
+    if (std::ifstream(libraryPath).good()) {
+        return 0;
+    }
+    
+    // Every compilation writes and compiles its own files and renames them into place,
+    // so processes compiling the same brain never read or load half written files
+    std::string temporarySourcePath;
+    std::string temporaryLibraryPath;
+    if (createUniqueFile(sourcePath, ".cpp", temporarySourcePath) != 0) {
+        return -1;
+    }
+    if (createUniqueFile(libraryPath, ".tmp", temporaryLibraryPath) != 0) {
+        std::remove(temporarySourcePath.c_str());
+        return -1;
+    }
+    
+    std::ofstream sourceFile(temporarySourcePath);
+    sourceFile << source;
+    sourceFile.close();
+    
+    // Compiler may be given with a launcher, e.g. "ccache c++", its words are split by spaces without any shell expansion
+    const char *compiler = std::getenv("CXX");
+    std::vector<std::string> arguments;
+    std::istringstream words(compiler != NULL ? compiler : "c++");
+    for (std::string word; words >> word;) {
+        arguments.push_back(word);
+    }
+    if (arguments.empty()) {
+        arguments.push_back("c++");
+    }
+    arguments.insert(arguments.end(), {"-O2", "-shared", "-fPIC", "-o", temporaryLibraryPath, temporarySourcePath});
+    
+    int error = !sourceFile || run(arguments) != 0 || std::rename(temporarySourcePath.c_str(), sourcePath.c_str()) != 0
+        || std::rename(temporaryLibraryPath.c_str(), libraryPath.c_str()) != 0;
+    std::remove(temporarySourcePath.c_str());
+    if (error) {
+        std::remove(temporaryLibraryPath.c_str());
+        return -1;
+    }
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+int BrainCompiler::load(Brain &brain, std::string cacheDirectory)
+{
+    std::string libraryPath;
+    int error = compile(emit(brain), cacheDirectory, libraryPath);
+    if (error != 0) {
+        return error;
+    }
+    
+    return load(libraryPath, (int)brain.neurons.size());
+}
+
+int BrainCompiler::load(std::string libraryPath, int numberOfNeurons_)
+{
+    unload();
+    
+#ifdef BRAIN_COMPILER_SUPPORTED
+    handle = dlopen(libraryPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == NULL) {
+        return -1;
+    }
+    
+    kernel = (BrainKernel)dlsym(handle, kernelName);
+    if (kernel == NULL) {
+        unload();
+        return -1;
+    }
+    
+    numberOfNeurons = numberOfNeurons_;
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+void BrainCompiler::unload()
+{
+#ifdef BRAIN_COMPILER_SUPPORTED
+    if (handle != NULL) {
+        dlclose(handle);
+    }
+#endif
+    handle = NULL;
+    kernel = NULL;
+    numberOfNeurons = 0;
+}
+
+BrainKernel BrainCompiler::getKernel()
+{
+    return kernel;
+}
+
+int BrainCompiler::getNumberOfNeurons()
+{
+    return numberOfNeurons;
+}
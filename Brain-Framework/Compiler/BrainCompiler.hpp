@@ -0,0 +1,85 @@
+//
+//  BrainCompiler.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef BrainCompiler_hpp
+#define BrainCompiler_hpp
+
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+
+#include "../Models/Brain.hpp"
+
+/// Kernel emitted by `BrainCompiler`, runs `numberOfSteps` ms of simulation.
+/// All per step arrays are laid out as [step * numberOfNeurons + neuron].
+/// @param v `v` values of neurons, updated in place
+/// @param u `u` values of neurons, updated in place
+/// @param sensoryI Sum of visual, distance and audio input currents per neuron
+/// @param noise Noise current per step and neuron
+/// @param iStep Output, total input current per step and neuron
+/// @param spikesStep Output, 1 for spiking neurons per step, has to be zeroed by the caller
+/// @param numberOfSteps Number of ms to simulate
+typedef void (*BrainKernel)(double *v, double *u, const double *sensoryI, const double *noise, double *iStep, uint8_t *spikesStep, int numberOfSteps);
+
+/// Emits C++ source of a kernel specialized for one brain, with connectome and neuron parameters baked in as constants,
+/// compiles it with the local compiler and loads it with `dlopen`.
+/// Meant for small brains on macOS and Linux, loading of compiled code is not allowed on iOS.
+class BrainCompiler {
+    
+private:
+    
+    void *handle = NULL;
+    BrainKernel kernel = NULL;
+    int numberOfNeurons = 0;
+    
+public:
+    
+    /// Name of exported kernel function.
+    static const char *kernelName;
+    
+    ~BrainCompiler();
+    
+    /// Emits kernel source for given brain.
+    /// @param brain Loaded brain
+    static std::string emit(Brain &brain);
+    
+    /// Returns 64-bit FNV-1a hash of given text.
+    static uint64_t hash(const std::string &text);
+    
+    /// Compiles kernel source into shared library, if library with the same content hash isn't cached already.
+    /// Compiler is taken from `CXX` environment variable, `c++` is used if it's not set. It's run without shell,
+    /// so words of `CXX` are split by spaces only.
+    /// @param source Kernel source, see `emit`
+    /// @param cacheDirectory Existing directory where sources and libraries are kept
+    /// @param libraryPath Output, path of compiled library
+    /// @return Non zero value indicates to occurred error
+    static int compile(const std::string &source, std::string cacheDirectory, std::string &libraryPath);
+    
+    /// Emits, compiles (or takes from cache) and loads kernel for given brain.
+    /// @param brain Loaded brain
+    /// @param cacheDirectory Existing directory where sources and libraries are kept
+    /// @return Non zero value indicates to occurred error
+    int load(Brain &brain, std::string cacheDirectory);
+    
+    /// Loads kernel from compiled library.
+    /// @param libraryPath Path to the shared library
+    /// @param numberOfNeurons_ Number of neurons of brain the library was compiled for
+    /// @return Non zero value indicates to occurred error
+    int load(std::string libraryPath, int numberOfNeurons_);
+    
+    /// Unloads kernel.
+    void unload();
+    
+    /// Returns loaded kernel, NULL if there isn't any.
+    BrainKernel getKernel();
+    
+    /// Returns number of neurons of brain the loaded kernel was compiled for.
+    int getNumberOfNeurons();
+};
+
+#endif /* BrainCompiler_hpp */
@@ -0,0 +1,38 @@
+//
+//  LatencyHistogram.cpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "LatencyHistogram.hpp"
+
+#include <limits>
+
+const double LatencyHistogram::bucketLimits[LatencyHistogram::numberOfBuckets] = {
+    1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, std::numeric_limits<double>::infinity()
+};
+
+void LatencyHistogram::add(double ms)
+{
+    int bucket = 0;
+    while (bucket < numberOfBuckets - 1 && ms > bucketLimits[bucket]) {
+        bucket++;
+    }
+    counts[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::getCounts(uint64_t counts_[numberOfBuckets]) const
+{
+    for (int i = 0; i < numberOfBuckets; i++) {
+        counts_[i] = counts[i].load(std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (int i = 0; i < numberOfBuckets; i++) {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,40 @@
+//
+//  LatencyHistogram.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef LatencyHistogram_hpp
+#define LatencyHistogram_hpp
+
+#include <iostream>
+#include <atomic>
+
+/// Lock-free histogram of latencies with fixed buckets, can be added to and read from any thread.
+class LatencyHistogram {
+    
+public:
+    
+    static const int numberOfBuckets = 12;
+    
+    /// Upper limits of buckets in ms, the last bucket has no limit.
+    static const double bucketLimits[numberOfBuckets];
+    
+    /// Counts one latency.
+    /// @param ms Latency in ms
+    void add(double ms);
+    
+    /// Copies counts of all buckets.
+    /// @param counts Output with `numberOfBuckets` elements
+    void getCounts(uint64_t counts[numberOfBuckets]) const;
+    
+    void reset();
+    
+private:
+    
+    std::atomic<uint64_t> counts[numberOfBuckets] = {};
+};
+
+#endif /* LatencyHistogram_hpp */
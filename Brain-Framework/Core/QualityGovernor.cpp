@@ -0,0 +1,58 @@
+//
+//  QualityGovernor.cpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "QualityGovernor.hpp"
+
+// Resolution is given up first, then audio and vision frames
+const QualityLevel QualityGovernor::levels[QualityGovernor::numberOfLevels] = {
+    { 227, 1, 1 },
+    { 113, 1, 1 },
+    { 57, 1, 1 },
+    { 57, 2, 1 },
+    { 57, 2, 2 },
+};
+
+/// Weight of the newest loop in smoothed load
+static const double smoothing = 0.2;
+/// Quality is lowered above this load
+static const double overloadThreshold = 0.85;
+/// Quality is raised after load stays below this threshold for `recoveryLoops`
+static const double headroomThreshold = 0.5;
+static const int recoveryLoops = 30;
+/// Loops after a change before level can change again, so the load of the new level is measured first
+static const int holdLoops = 10;
+
+int QualityGovernor::update(double loopLoad)
+{
+    load += smoothing * (loopLoad - load);
+    loopsAtLevel++;
+    loopsWithHeadroom = load < headroomThreshold ? loopsWithHeadroom + 1 : 0;
+    
+    if (loopsAtLevel < holdLoops) {
+        return level;
+    }
+    
+    if (load > overloadThreshold && level < numberOfLevels - 1) {
+        level++;
+        loopsAtLevel = 0;
+        loopsWithHeadroom = 0;
+    } else if (loopsWithHeadroom >= recoveryLoops && level > 0) {
+        level--;
+        loopsAtLevel = 0;
+        loopsWithHeadroom = 0;
+    }
+    return level;
+}
+
+void QualityGovernor::reset()
+{
+    load = 0;
+    level = 0;
+    loopsAtLevel = 0;
+    loopsWithHeadroom = 0;
+}
@@ -0,0 +1,50 @@
+//
+//  QualityGovernor.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef QualityGovernor_hpp
+#define QualityGovernor_hpp
+
+#include <iostream>
+
+/// Quality of sensory processing at one level of `QualityGovernor`.
+class QualityLevel {
+public:
+    
+    /// Width and height of eye frames in pixels
+    int eyeSize;
+    /// Audio samples are averaged in groups of this size before spectrum is computed
+    int audioDecimation;
+    /// Only every n-th submitted video frame is processed
+    int visionFrameInterval;
+};
+
+/// Lowers quality of sensory processing while the loop runs out of time and raises it again once there is headroom.
+/// Load is smoothed and levels change with hysteresis, so a single slow loop or a short spike doesn't change quality.
+class QualityGovernor {
+    
+    double load = 0;
+    int level = 0;
+    int loopsAtLevel = 0;
+    int loopsWithHeadroom = 0;
+    
+public:
+    
+    /// Levels from full quality to the cheapest one
+    static const int numberOfLevels = 5;
+    static const QualityLevel levels[numberOfLevels];
+    
+    /// Adds load of one loop and changes level if needed.
+    /// @param loopLoad Busy time of loop divided by its period, above 1 means that deadline was missed
+    /// @return Level after the update, index in `levels`
+    int update(double loopLoad);
+    
+    /// Returns to full quality.
+    void reset();
+};
+
+#endif /* QualityGovernor_hpp */
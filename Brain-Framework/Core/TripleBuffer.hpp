@@ -0,0 +1,69 @@
+//
+//  TripleBuffer.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef TripleBuffer_hpp
+#define TripleBuffer_hpp
+
+#include <atomic>
+
+/// Lock-free single producer, single consumer triple buffer.
+/// Producer fills `writeBuffer` and publishes it, consumer takes the newest published buffer with `update`.
+/// Neither side ever blocks, the producer simply overwrites buffers the consumer didn't take.
+template <typename T>
+class TripleBuffer {
+    
+private:
+    
+    static const int indexMask = 3;
+    static const int newDataBit = 4;
+    
+    T buffers[3];
+    
+    /// Index of buffer shared between producer and consumer, `newDataBit` is set while it wasn't taken by consumer.
+    std::atomic<int> middle { 1 };
+    
+    /// Index of buffer owned by producer.
+    int back = 0;
+    
+    /// Index of buffer owned by consumer.
+    int front = 2;
+    
+public:
+    
+    /// Access to all buffers, only for preallocation while neither producer nor consumer runs.
+    /// @param index Index in range [0, 3)
+    T &buffer(int index) { return buffers[index]; }
+    
+    /// Producer: buffer to fill.
+    T &writeBuffer() { return buffers[back]; }
+    
+    /// Producer: publishes filled buffer and gets a free one.
+    /// @return True if the buffer given back to producer was published before and consumer never took it
+    bool publish()
+    {
+        int previous = middle.exchange(back | newDataBit, std::memory_order_acq_rel);
+        back = previous & indexMask;
+        return (previous & newDataBit) != 0;
+    }
+    
+    /// Consumer: takes the newest published buffer.
+    /// @return True if there was a buffer published since the last update
+    bool update()
+    {
+        if ((middle.load(std::memory_order_acquire) & newDataBit) == 0) {
+            return false;
+        }
+        front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+    
+    /// Consumer: buffer taken by the last update.
+    T &readBuffer() { return buffers[front]; }
+};
+
+#endif /* TripleBuffer_hpp */
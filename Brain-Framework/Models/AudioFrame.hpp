@@ -0,0 +1,27 @@
+//
+//  AudioFrame.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef AudioFrame_hpp
+#define AudioFrame_hpp
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+
+/// Audio buffer submitted to simulation.
+class AudioFrame {
+public:
+    
+    /// When microphone captured the buffer
+    std::chrono::steady_clock::time_point captureTime;
+    
+    int sampleRate = 0;
+    std::vector<float> samples;
+};
+
+#endif /* AudioFrame_hpp */
@@ -0,0 +1,29 @@
+//
+//  Blob.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef Blob_hpp
+#define Blob_hpp
+
+#include <iostream>
+#include <opencv2/opencv.hpp>
+
+/// Connected region of a color mask.
+class Blob {
+public:
+    
+    /// Number of pixels
+    int area = 0;
+    /// Mean column of pixels
+    double centroidX = 0;
+    /// Mean row of pixels
+    double centroidY = 0;
+    /// Bounding box
+    cv::Rect bounds;
+};
+
+#endif /* Blob_hpp */
@@ -59,7 +59,10 @@ int Brain::load(std::string filePath_, double msPerStep_, double nStepsPerLoop_)
     }
     
     spikesLoop = std::vector<std::vector<double> >(numberOfNeurons, std::vector<double>(msPerStep_ * nStepsPerLoop_, 0));
-    visPrefVals = std::vector<std::vector<double> >(neurons.front().visPref.size(), std::vector<double>(2, 0));
+    
+    // One column per camera of brain file
+    size_t numberOfCameras = neurons.front().visPref.empty() ? 0 : neurons.front().visPref.front().size();
+    visPrefVals = std::vector<std::vector<double> >(neurons.front().visPref.size(), std::vector<double>(numberOfCameras, 0));
     
     return 0;
 }
@@ -0,0 +1,26 @@
+//
+//  CatchUpPolicy.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef CatchUpPolicy_hpp
+#define CatchUpPolicy_hpp
+
+#include <iostream>
+
+/// What simulation does when an iteration overruns its period and falls behind wall-clock.
+typedef enum : int {
+    /// Sleeps full period after every iteration, time spent in iteration is lost.
+    CatchUpPolicyNone = 0,
+    /// Skips audio processing until simulation catches up, vision runs on its own thread.
+    CatchUpPolicySkipSensors,
+    /// Runs missed neural loops back to back, sensory input is reused.
+    CatchUpPolicyBurst,
+    /// Doesn't catch up, lag is only declared.
+    CatchUpPolicyDeclareLag,
+} CatchUpPolicy;
+
+#endif /* CatchUpPolicy_hpp */
@@ -14,6 +14,15 @@
 typedef enum : int {
     ColorSpaceRGB = 0,
     ColorSpaceBGRA,
+    /// YUV 4:2:0, full range BT.601, luma plane followed by one plane of interleaved U and V
+    ColorSpaceNV12,
+    /// YUV 4:2:0, full range BT.601, luma plane followed by U plane and V plane
+    ColorSpaceI420,
+    /// Raw Bayer mosaic with one byte per sample, even rows are R G and odd rows are G B.
+    /// Every 2x2 quad is one pixel of half resolution, there is no demosaicing.
+    ColorSpaceBayerRGGB,
+    /// Raw Bayer mosaic like `ColorSpaceBayerRGGB`, even rows are B G and odd rows are G R
+    ColorSpaceBayerBGGR,
 } ColorSpace;
 
 #endif /* ColorSpace_h */
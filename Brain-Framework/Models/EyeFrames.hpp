@@ -0,0 +1,38 @@
+//
+//  EyeFrames.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef EyeFrames_hpp
+#define EyeFrames_hpp
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <opencv2/opencv.hpp>
+
+#include "ColorSpace.h"
+
+/// Resized eye frames of one camera frame, handed from vision to feature extraction.
+class EyeFrames {
+public:
+    
+    /// Sequence number of the camera frame.
+    uint64_t frameNumber = 0;
+    
+    /// When vision took the camera frame.
+    std::chrono::steady_clock::time_point timestamp;
+    
+    /// When the oldest camera frame which vision used was captured.
+    std::chrono::steady_clock::time_point captureTime;
+    
+    ColorSpace colorSpace = ColorSpaceRGB;
+    
+    /// Frames indexed by eye, see `BrainWorker::setEyeLayout`
+    std::vector<cv::Mat> frames;
+};
+
+#endif /* EyeFrames_hpp */
@@ -0,0 +1,30 @@
+//
+//  EyeRegion.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef EyeRegion_hpp
+#define EyeRegion_hpp
+
+#include <iostream>
+#include <opencv2/opencv.hpp>
+
+#include "CameraType.hpp"
+
+/// Region of a camera frame seen by one eye, see `BrainWorker::setEyeLayout`.
+class EyeRegion {
+public:
+    
+    /// Index of source frame, see `BrainWorker::setVideo`
+    int source = 0;
+    /// Crop of source frame in pixels, it's resized to a square so square crops keep proportions of objects.
+    /// Empty rectangle at origin is the whole frame, see `BrainWorker::submitEyeFrame`.
+    cv::Rect rect;
+    /// Side whose rule of temporal score the eye uses, see `BrainWorker::calculateScore`
+    CameraType camera = CameraTypeLeft;
+};
+
+#endif /* EyeRegion_hpp */
@@ -0,0 +1,33 @@
+//
+//  LatencyStage.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef LatencyStage_hpp
+#define LatencyStage_hpp
+
+#include <iostream>
+
+/// Measured latencies, see `BrainWorker::getLatencyHistogram`.
+typedef enum : int {
+    /// From capture of camera frame until vision takes it.
+    LatencyStageVideoQueue = 0,
+    /// Vision processing of camera frame.
+    LatencyStageVision,
+    /// From end of vision until simulation takes its visual input.
+    LatencyStageVisionHandoff,
+    /// Simulation loop, from its start until its outputs are published.
+    LatencyStageLoop,
+    /// Ages of inputs behind every published output, see `SimulationOutput`.
+    LatencyStageVideoAge,
+    LatencyStageFeatureAge,
+    LatencyStageAudioAge,
+    LatencyStageDistanceAge,
+    
+    LatencyStageCount,
+} LatencyStage;
+
+#endif /* LatencyStage_hpp */
@@ -0,0 +1,40 @@
+//
+//  SimulationOutput.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef SimulationOutput_hpp
+#define SimulationOutput_hpp
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+
+/// Outputs of one completed simulation loop.
+class SimulationOutput {
+public:
+    
+    /// Number of the loop which produced outputs, 0 before the first loop.
+    uint64_t generation = 0;
+    
+    double leftTorque = 0;
+    double rightTorque = 0;
+    float speakerTone = 0;
+    
+    /// When outputs were published.
+    std::chrono::steady_clock::time_point timestamp;
+    
+    /// Ages in ms of sensory inputs behind outputs, from their capture until `timestamp`. -1 if there was no input yet.
+    double videoAge = -1;
+    double featureAge = -1;
+    double audioAge = -1;
+    double distanceAge = -1;
+    
+    std::vector<double> neuronValues;
+    std::vector<bool> firingNeurons;
+};
+
+#endif /* SimulationOutput_hpp */
@@ -0,0 +1,69 @@
+//
+//  VideoFrame.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef VideoFrame_hpp
+#define VideoFrame_hpp
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+#include "ColorSpace.h"
+
+/// Gives camera frame back to its owner once vision doesn't need it anymore.
+/// @param context Context passed with the frame
+typedef void (*VideoFrameRelease)(void *context);
+
+/// Camera frame submitted to vision.
+class VideoFrame {
+public:
+    
+    /// Number given to frame when it was submitted, starts with 1.
+    uint64_t sequenceNumber = 0;
+    
+    /// When camera captured the frame
+    std::chrono::steady_clock::time_point captureTime;
+    
+    /// Size of frame in pixels
+    int width = 0;
+    int height = 0;
+    
+    /// Color space of frame, see `ColorSpace.h`
+    ColorSpace colorSpace = ColorSpaceRGB;
+    
+    /// Luma and chroma planes of NV12 and I420 are separate, other color spaces have one plane.
+    static const int maxNumberOfPlanes = 3;
+    
+    /// First row of each plane, see `BrainWorker::submitVideoPlanes`.
+    /// Point into `data` for copied frames, NULL once a frame of its owner was released.
+    const uint8_t *planes[maxNumberOfPlanes] = {};
+    
+    /// Number of bytes between starts of rows of each plane, including padding
+    size_t bytesPerRow[maxNumberOfPlanes] = {};
+    
+    /// Pixels of copied frame
+    std::vector<uint8_t> data;
+    
+    /// Owner of frame which isn't copied, NULL for copied frames
+    VideoFrameRelease releaseCallback = NULL;
+    void *releaseContext = NULL;
+    
+    /// Gives frame back to its owner, copied frames stay valid.
+    void release()
+    {
+        if (releaseCallback) {
+            releaseCallback(releaseContext);
+            releaseCallback = NULL;
+            releaseContext = NULL;
+            std::fill(planes, planes + maxNumberOfPlanes, (const uint8_t *)NULL);
+        }
+    }
+};
+
+#endif /* VideoFrame_hpp */
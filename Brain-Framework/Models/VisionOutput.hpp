@@ -0,0 +1,36 @@
+//
+//  VisionOutput.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef VisionOutput_hpp
+#define VisionOutput_hpp
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+
+/// Visual input computed from one camera frame.
+class VisionOutput {
+public:
+    
+    /// Sequence number of the processed camera frame, 0 before the first frame.
+    uint64_t frameNumber = 0;
+    
+    /// When vision took the frame.
+    std::chrono::steady_clock::time_point timestamp;
+    
+    /// When the oldest camera frame which vision used was captured.
+    std::chrono::steady_clock::time_point captureTime;
+    
+    /// When vision finished.
+    std::chrono::steady_clock::time_point processedTime;
+    
+    /// Values indexed by visual preference and camera, same layout as `Brain::visPrefVals`
+    std::vector<std::vector<double>> visPrefVals;
+};
+
+#endif /* VisionOutput_hpp */
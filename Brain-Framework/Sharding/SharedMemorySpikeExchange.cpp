@@ -0,0 +1,242 @@
+//
+//  SharedMemorySpikeExchange.cpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "SharedMemorySpikeExchange.hpp"
+
+#include <thread>
+#include <chrono>
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "Cross-process barrier requires lock free atomics");
+
+static const uint32_t spikeExchangeMagic = 0x42594253; // BYBS
+static const int attachTimeoutMs = 10000;
+/// Shards which don't arrive at a step in time are treated as gone
+static const int barrierTimeoutMs = 10000;
+/// Polls of barrier before waiting shard sleeps, shards of fast steps arrive within them
+static const int barrierSpins = 2000;
+
+SharedMemorySpikeExchange::~SharedMemorySpikeExchange()
+{
+    close();
+}
+
+int SharedMemorySpikeExchange::open(std::string name_, int shardIndex_, int numberOfShards_, int capacity_, uint64_t session_)
+{
+    if (shardIndex_ < 0 || shardIndex_ >= numberOfShards_ || capacity_ < 0) {
+        return -1;
+    }
+    
+    close();
+    
+    name = name_;
+    index = shardIndex_;
+    shards = numberOfShards_;
+    capacity = capacity_;
+    session = session_;
+    mappedSize = sizeof(Header) + sizeof(int32_t) * ringSize * shards * (capacity + 1);
+    
+    if (index == 0) {
+        // Stale object may be left from a crashed run
+        shm_unlink(name.c_str());
+        fileDescriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fileDescriptor < 0 || ftruncate(fileDescriptor, mappedSize) != 0) {
+            close();
+            return -1;
+        }
+        void *memory = mmap(NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+        if (memory == MAP_FAILED) {
+            close();
+            return -1;
+        }
+        header = (Header *)memory;
+        slots = (int32_t *)((uint8_t *)memory + sizeof(Header));
+        
+        header->magic = spikeExchangeMagic;
+        header->numberOfShards = shards;
+        header->capacity = capacity;
+        header->ringSize = ringSize;
+        header->session = session;
+        header->closed.store(0, std::memory_order_relaxed);
+        header->arrived.store(0, std::memory_order_relaxed);
+        header->generation.store(0, std::memory_order_relaxed);
+        
+        pthread_mutexattr_t mutexAttributes;
+        pthread_condattr_t conditionAttributes;
+        pthread_mutexattr_init(&mutexAttributes);
+        pthread_mutexattr_setpshared(&mutexAttributes, PTHREAD_PROCESS_SHARED);
+        pthread_condattr_init(&conditionAttributes);
+        pthread_condattr_setpshared(&conditionAttributes, PTHREAD_PROCESS_SHARED);
+        int error = pthread_mutex_init(&header->mutex, &mutexAttributes) | pthread_cond_init(&header->condition, &conditionAttributes);
+        pthread_mutexattr_destroy(&mutexAttributes);
+        pthread_condattr_destroy(&conditionAttributes);
+        if (error != 0) {
+            close();
+            return -1;
+        }
+        header->ready.store(spikeExchangeMagic, std::memory_order_release);
+    } else if (attach() != 0) {
+        close();
+        return -1;
+    }
+    
+    // All shards have to be attached before the first step
+    return barrier();
+}
+
+int SharedMemorySpikeExchange::attach()
+{
+    struct stat fileStat;
+    for (int waitedMs = 0; waitedMs <= attachTimeoutMs; waitedMs++) {
+        if (waitedMs > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        
+        // Object of another session is reopened, shard 0 may have replaced it meanwhile
+        int descriptor = shm_open(name.c_str(), O_RDWR, 0600);
+        if (descriptor < 0) {
+            continue;
+        }
+        void *memory = MAP_FAILED;
+        if (fstat(descriptor, &fileStat) == 0 && fileStat.st_size >= (off_t)mappedSize) {
+            memory = mmap(NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        }
+        if (memory == MAP_FAILED) {
+            ::close(descriptor);
+            continue;
+        }
+        
+        Header *candidate = (Header *)memory;
+        if (candidate->ready.load(std::memory_order_acquire) != spikeExchangeMagic || candidate->session != session) {
+            munmap(memory, mappedSize);
+            ::close(descriptor);
+            continue;
+        }
+        if (candidate->numberOfShards != shards || candidate->capacity != capacity || candidate->ringSize != ringSize) {
+            munmap(memory, mappedSize);
+            ::close(descriptor);
+            return -1;
+        }
+        
+        fileDescriptor = descriptor;
+        header = candidate;
+        slots = (int32_t *)((uint8_t *)memory + sizeof(Header));
+        return 0;
+    }
+    return -1;
+}
+
+void SharedMemorySpikeExchange::close()
+{
+    if (header != NULL) {
+        // Only shard 0 initializes the barrier, others attach once it's ready
+        if (header->ready.load(std::memory_order_acquire) == spikeExchangeMagic) {
+            pthread_mutex_lock(&header->mutex);
+            header->closed.store(1, std::memory_order_release);
+            pthread_cond_broadcast(&header->condition);
+            pthread_mutex_unlock(&header->mutex);
+        }
+        munmap(header, mappedSize);
+        header = NULL;
+        slots = NULL;
+    }
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+        if (index == 0) {
+            shm_unlink(name.c_str());
+        }
+    }
+}
+
+int SharedMemorySpikeExchange::shardIndex()
+{
+    return index;
+}
+
+int SharedMemorySpikeExchange::numberOfShards()
+{
+    return shards;
+}
+
+int32_t *SharedMemorySpikeExchange::slot(long step, int shard)
+{
+    return slots + ((step % ringSize) * shards + shard) * (capacity + 1);
+}
+
+int SharedMemorySpikeExchange::barrier()
+{
+    pthread_mutex_lock(&header->mutex);
+    uint32_t generation = header->generation.load(std::memory_order_relaxed);
+    if (header->arrived.load(std::memory_order_relaxed) + 1 == (uint32_t)shards) {
+        header->arrived.store(0, std::memory_order_relaxed);
+        header->generation.store(generation + 1, std::memory_order_release);
+        pthread_cond_broadcast(&header->condition);
+        pthread_mutex_unlock(&header->mutex);
+        return 0;
+    }
+    header->arrived.store(header->arrived.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    pthread_mutex_unlock(&header->mutex);
+    
+    // Shards of fast steps arrive while spinning, so they don't pay for sleeping and waking up
+    for (int spins = 0; spins < barrierSpins; spins++) {
+        if (header->generation.load(std::memory_order_acquire) != generation) {
+            return 0;
+        }
+    }
+    
+    // Condition uses realtime clock, the only one all platforms support for shared conditions
+    timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    long nanoseconds = deadline.tv_nsec + (barrierTimeoutMs % 1000) * 1000000L;
+    deadline.tv_sec += barrierTimeoutMs / 1000 + nanoseconds / 1000000000L;
+    deadline.tv_nsec = nanoseconds % 1000000000L;
+    
+    pthread_mutex_lock(&header->mutex);
+    int error = 0;
+    while (header->generation.load(std::memory_order_acquire) == generation && header->closed.load(std::memory_order_relaxed) == 0
+           && error != ETIMEDOUT) {
+        error = pthread_cond_timedwait(&header->condition, &header->mutex, &deadline);
+    }
+    bool passed = header->generation.load(std::memory_order_acquire) != generation;
+    if (!passed) {
+        // Other shards stop as well
+        header->closed.store(1, std::memory_order_release);
+        pthread_cond_broadcast(&header->condition);
+    }
+    pthread_mutex_unlock(&header->mutex);
+    return passed ? 0 : -1;
+}
+
+int SharedMemorySpikeExchange::exchange(long step, const std::vector<int> &localSpikes, std::vector<int> &allSpikes)
+{
+    if (header == NULL || localSpikes.size() > (size_t)capacity) {
+        return -1;
+    }
+    
+    int32_t *localSlot = slot(step, index);
+    localSlot[0] = (int32_t)localSpikes.size();
+    std::copy(localSpikes.begin(), localSpikes.end(), localSlot + 1);
+    
+    if (barrier() != 0) {
+        return -1;
+    }
+    
+    allSpikes.clear();
+    for (int shard = 0; shard < shards; shard++) {
+        int32_t *shardSlot = slot(step, shard);
+        allSpikes.insert(allSpikes.end(), shardSlot + 1, shardSlot + 1 + shardSlot[0]);
+    }
+    
+    return 0;
+}
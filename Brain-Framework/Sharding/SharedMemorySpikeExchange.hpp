@@ -0,0 +1,88 @@
+//
+//  SharedMemorySpikeExchange.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef SharedMemorySpikeExchange_hpp
+#define SharedMemorySpikeExchange_hpp
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <pthread.h>
+
+#include "SpikeExchange.hpp"
+
+/// Single host implementation of `SpikeExchange`.
+/// Shards are separate processes which map the same POSIX shared memory object.
+/// It holds a ring of per step spike lists (one list per shard) and a cross-process barrier.
+class SharedMemorySpikeExchange : public SpikeExchange {
+    
+private:
+    
+    struct Header {
+        uint32_t magic;
+        int32_t numberOfShards;
+        int32_t capacity;
+        int32_t ringSize;
+        uint64_t session;
+        std::atomic<uint32_t> ready;
+        std::atomic<uint32_t> closed;
+        std::atomic<uint32_t> arrived;
+        std::atomic<uint32_t> generation;
+        
+        /// Process-shared, guard the counters above, shards which didn't pass barrier while spinning sleep on `condition`
+        pthread_mutex_t mutex;
+        pthread_cond_t condition;
+    };
+    
+    /// Ring of 2 is enough: a shard can't write step + 2 before all shards passed the barrier of step + 1,
+    /// which they do only after reading step.
+    static const int ringSize = 2;
+    
+    std::string name;
+    int index = 0;
+    int shards = 0;
+    int capacity = 0;
+    uint64_t session = 0;
+    int fileDescriptor = -1;
+    size_t mappedSize = 0;
+    Header *header = NULL;
+    int32_t *slots = NULL;
+    
+    /// Returns list for given step and shard, first element is number of spikes.
+    int32_t *slot(long step, int shard);
+    
+    /// Maps shared memory object once shard 0 created it for the same session.
+    /// @return Non zero value if it wasn't created in time
+    int attach();
+    
+    /// Waits until all shards arrive, spins shortly and sleeps on the shared condition after that.
+    /// @return Non zero value if the exchange was closed meanwhile or shards didn't arrive in time
+    int barrier();
+    
+public:
+    
+    ~SharedMemorySpikeExchange();
+    
+    /// Creates (shard 0) or attaches to (other shards) shared memory object.
+    /// @param name_ Name of shared memory object, e.g. "/neurorobot", max 31 characters on Apple platforms
+    /// @param shardIndex_ Index of this shard
+    /// @param numberOfShards_ Number of shards
+    /// @param capacity_ Max number of neurons owned by one shard
+    /// @param session_ Number of the run, the same for all its shards, so objects left by crashed runs aren't attached to
+    /// @return Non zero value indicates to occurred error
+    int open(std::string name_, int shardIndex_, int numberOfShards_, int capacity_, uint64_t session_);
+    
+    /// Releases shared memory and wakes up shards waiting on the barrier.
+    void close();
+    
+    int shardIndex();
+    int numberOfShards();
+    int exchange(long step, const std::vector<int> &localSpikes, std::vector<int> &allSpikes);
+};
+
+#endif /* SharedMemorySpikeExchange_hpp */
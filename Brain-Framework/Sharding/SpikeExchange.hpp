@@ -0,0 +1,37 @@
+//
+//  SpikeExchange.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef SpikeExchange_hpp
+#define SpikeExchange_hpp
+
+#include <vector>
+
+/// Transport used by sharded simulation to exchange spikes between shards.
+/// Every shard owns a contiguous range of neurons and once per simulated ms publishes indices of its spiking neurons.
+/// `exchange` has barrier semantics: it returns only when spikes of all shards for the given step are available.
+class SpikeExchange {
+    
+public:
+    
+    virtual ~SpikeExchange() {}
+    
+    /// Index of this shard, in range [0, numberOfShards).
+    virtual int shardIndex() = 0;
+    
+    /// Number of shards taking part in the exchange.
+    virtual int numberOfShards() = 0;
+    
+    /// Publishes spikes of this shard and collects spikes of all shards for given step.
+    /// @param step Simulation step (ms), has to be the same on all shards
+    /// @param localSpikes Global indices of spiking neurons owned by this shard
+    /// @param allSpikes Output, global indices of spiking neurons of all shards
+    /// @return Non zero value indicates to occurred error, e.g. one of the shards left
+    virtual int exchange(long step, const std::vector<int> &localSpikes, std::vector<int> &allSpikes) = 0;
+};
+
+#endif /* SpikeExchange_hpp */
@@ -0,0 +1,62 @@
+//
+//  BlobDetector.cpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "BlobDetector.hpp"
+
+Blob BlobDetector::labelLargestBlob(const cv::Mat &mask)
+{
+    return labeler.largestBlob(mask);
+}
+
+Blob BlobDetector::largestBlob(const cv::Mat &mask)
+{
+    isTracking = false;
+    return labelLargestBlob(mask);
+}
+
+Blob BlobDetector::trackLargestBlob(const cv::Mat &mask)
+{
+    cv::Rect frame(0, 0, mask.cols, mask.rows);
+    
+    // Bounds of previous blob are in coordinates of masks of the previous size
+    if (mask.size() != previousSize) {
+        isTracking = false;
+        previousSize = mask.size();
+    }
+    
+    if (isTracking && previousBlob.area > 0 && framesSinceRefresh < refreshPeriod) {
+        cv::Rect window = frame & cv::Rect(previousBlob.bounds.x - margin, previousBlob.bounds.y - margin,
+                                           previousBlob.bounds.width + 2 * margin, previousBlob.bounds.height + 2 * margin);
+        Blob blob = labelLargestBlob(mask(window));
+        
+        // Blob touching a window border which isn't a mask border may continue outside of the window
+        cv::Rect inner = blob.bounds;
+        bool touchesBorder = (inner.x == 0 && window.x > 0)
+            || (inner.y == 0 && window.y > 0)
+            || (inner.x + inner.width == window.width && window.x + window.width < frame.width)
+            || (inner.y + inner.height == window.height && window.y + window.height < frame.height);
+        
+        // Blob which shrank to less than half left the window or split, a bigger one may be elsewhere
+        if (blob.area > 0 && blob.area * 2 >= previousBlob.area && !touchesBorder) {
+            blob.centroidX += window.x;
+            blob.centroidY += window.y;
+            blob.bounds.x += window.x;
+            blob.bounds.y += window.y;
+            
+            framesSinceRefresh++;
+            previousBlob = blob;
+            return blob;
+        }
+    }
+    
+    Blob blob = labelLargestBlob(mask);
+    isTracking = true;
+    framesSinceRefresh = 0;
+    previousBlob = blob;
+    return blob;
+}
@@ -0,0 +1,53 @@
+//
+//  BlobDetector.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef BlobDetector_hpp
+#define BlobDetector_hpp
+
+#include <iostream>
+#include <opencv2/opencv.hpp>
+
+#include "../Models/Blob.hpp"
+#include "RunLabeler.hpp"
+
+/// Finds the largest connected region of a mask.
+/// Area, bounds and centroid of every component are accumulated while labeling runs of the mask, see `RunLabeler`.
+/// In tracking mode only a window around the blob of the previous frame is labeled. The whole mask is labeled when
+/// blob is lost or shrinks to less than half, when it touches the window border or every `refreshPeriod` frames,
+/// so a bigger blob which appears elsewhere is picked up with a delay of at most `refreshPeriod` frames.
+class BlobDetector {
+    
+    RunLabeler labeler;
+    
+    /// Tracking data
+    Blob previousBlob;
+    cv::Size previousSize;
+    bool isTracking = false;
+    int framesSinceRefresh = 0;
+    
+    /// Labels mask and returns its largest blob.
+    Blob labelLargestBlob(const cv::Mat &mask);
+    
+public:
+    
+    /// Pixels added to every side of the previous blob bounds to get the search window
+    int margin = 16;
+    /// Max number of consecutive frames searched only within the window
+    int refreshPeriod = 10;
+    
+    /// Returns the largest 8-connected blob of nonzero pixels.
+    /// If mask has no nonzero pixels, returned blob has zero area and centroid of the whole mask.
+    /// @param mask Mask of type `CV_8UC1`
+    Blob largestBlob(const cv::Mat &mask);
+    
+    /// Returns the largest blob, searching around the blob returned for the previous frame first.
+    /// @param mask Mask of type `CV_8UC1`, tracking starts over when its size changes
+    Blob trackLargestBlob(const cv::Mat &mask);
+};
+
+#endif /* BlobDetector_hpp */
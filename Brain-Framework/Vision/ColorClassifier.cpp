@@ -0,0 +1,359 @@
+//
+//  ColorClassifier.cpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "ColorClassifier.hpp"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSSE3__)
+    #include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+// Dominance tests in fixed-point, for 8-bit channels they give the same result as the original double math:
+//   r > 1.8 * g  <=>  5 * r > 9 * g
+//   g > 1.2 * r  <=>  5 * g > 6 * r
+//   b > 1.5 * g  <=>  2 * b > 3 * g
+
+static const int darkThreshold = 50;
+
+// Full range BT.601 with 8 fractional bits, channels of YUV pixels are scaled by 256:
+//   R = Y + 1.402 * V
+//   G = Y - 0.344 * U - 0.714 * V
+//   B = Y + 1.772 * U
+static const int yuvScale = 256;
+static const int vToRed = 359;
+static const int uToGreen = 88;
+static const int vToGreen = 183;
+static const int uToBlue = 454;
+
+static inline bool isYUV(ColorSpace colorSpace)
+{
+    return colorSpace == ColorSpaceNV12 || colorSpace == ColorSpaceI420;
+}
+
+static inline bool isBayer(ColorSpace colorSpace)
+{
+    return colorSpace == ColorSpaceBayerRGGB || colorSpace == ColorSpaceBayerBGGR;
+}
+
+// MARK: - SSE / AVX2
+
+#if defined(__SSSE3__)
+
+/// Splits 16 RGB pixels into channels.
+static inline void deinterleaveRGB(const uint8_t *pixels, __m128i &c0, __m128i &c1, __m128i &c2)
+{
+    __m128i a = _mm_loadu_si128((const __m128i *)pixels);
+    __m128i b = _mm_loadu_si128((const __m128i *)(pixels + 16));
+    __m128i c = _mm_loadu_si128((const __m128i *)(pixels + 32));
+    
+    c0 = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(a, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1))),
+        _mm_shuffle_epi8(c, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)));
+    c1 = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(a, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1))),
+        _mm_shuffle_epi8(c, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)));
+    c2 = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(a, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1))),
+        _mm_shuffle_epi8(c, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)));
+}
+
+/// Splits 16 BGRA pixels into channels, alpha is dropped.
+static inline void deinterleaveBGRA(const uint8_t *pixels, __m128i &c0, __m128i &c1, __m128i &c2)
+{
+    // Group channels of 4 pixels into 32-bit lanes, then transpose lanes
+    const __m128i group = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    __m128i a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)pixels), group);
+    __m128i b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(pixels + 16)), group);
+    __m128i c = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(pixels + 32)), group);
+    __m128i d = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(pixels + 48)), group);
+    
+    __m128i ab01 = _mm_unpacklo_epi32(a, b);
+    __m128i cd01 = _mm_unpacklo_epi32(c, d);
+    __m128i ab23 = _mm_unpackhi_epi32(a, b);
+    __m128i cd23 = _mm_unpackhi_epi32(c, d);
+    
+    c0 = _mm_unpacklo_epi64(ab01, cd01);
+    c1 = _mm_unpackhi_epi64(ab01, cd01);
+    c2 = _mm_unpacklo_epi64(ab23, cd23);
+}
+
+/// Splits 16 pixels in given color space into red, green and blue channels.
+static inline void deinterleave(const uint8_t *pixels, ColorSpace colorSpace, __m128i &r, __m128i &g, __m128i &b)
+{
+    if (colorSpace == ColorSpaceBGRA) {
+        deinterleaveBGRA(pixels, b, g, r);
+    } else {
+        deinterleaveRGB(pixels, r, g, b);
+    }
+}
+
+#endif
+
+#if defined(__AVX2__)
+
+/// Returns 0xFF for pixels where x * xScale > y * yScale.
+static inline __m256i greaterScaled(__m256i x, __m256i y, __m256i xScale, __m256i yScale)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i low = _mm256_cmpgt_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(x, zero), xScale),
+                                     _mm256_mullo_epi16(_mm256_unpacklo_epi8(y, zero), yScale));
+    __m256i high = _mm256_cmpgt_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(x, zero), xScale),
+                                      _mm256_mullo_epi16(_mm256_unpackhi_epi8(y, zero), yScale));
+    return _mm256_packs_epi16(low, high);
+}
+
+static inline __m256i zeroBelow(__m256i x, __m256i threshold)
+{
+    return _mm256_and_si256(x, _mm256_cmpeq_epi8(_mm256_max_epu8(x, threshold), x));
+}
+
+static inline __m256i combine(__m128i low, __m128i high)
+{
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+}
+
+/// Classifies 32 pixels per iteration.
+/// @return Number of classified pixels
+static int classifyRowSIMD(const uint8_t *pixels, int width, ColorSpace colorSpace, uint8_t *red, uint8_t *green, uint8_t *blue)
+{
+    const int bytesPerPixel = colorSpace == ColorSpaceBGRA ? 4 : 3;
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i threshold = _mm256_set1_epi8(darkThreshold);
+    const __m256i two = _mm256_set1_epi16(2);
+    const __m256i three = _mm256_set1_epi16(3);
+    const __m256i five = _mm256_set1_epi16(5);
+    const __m256i six = _mm256_set1_epi16(6);
+    const __m256i nine = _mm256_set1_epi16(9);
+    
+    int j = 0;
+    for (; j + 32 <= width; j += 32) {
+        __m128i r0, g0, b0, r1, g1, b1;
+        deinterleave(pixels + j * bytesPerPixel, colorSpace, r0, g0, b0);
+        deinterleave(pixels + (j + 16) * bytesPerPixel, colorSpace, r1, g1, b1);
+        __m256i r = combine(r0, r1);
+        __m256i g = combine(g0, g1);
+        __m256i b = combine(b0, b1);
+        
+        __m256i isRed = _mm256_and_si256(greaterScaled(r, g, five, nine), greaterScaled(r, b, five, nine));
+        r = zeroBelow(r, threshold);
+        __m256i isGreen = _mm256_and_si256(greaterScaled(g, r, five, six), greaterScaled(g, b, five, six));
+        g = zeroBelow(g, threshold);
+        __m256i isBlue = _mm256_and_si256(greaterScaled(b, g, two, three), greaterScaled(b, r, two, three));
+        
+        _mm256_storeu_si256((__m256i *)(red + j), _mm256_and_si256(isRed, one));
+        _mm256_storeu_si256((__m256i *)(green + j), _mm256_and_si256(isGreen, one));
+        _mm256_storeu_si256((__m256i *)(blue + j), _mm256_and_si256(isBlue, one));
+    }
+    return j;
+}
+
+#elif defined(__SSSE3__)
+
+/// Returns 0xFF for pixels where x * xScale > y * yScale.
+static inline __m128i greaterScaled(__m128i x, __m128i y, __m128i xScale, __m128i yScale)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i low = _mm_cmpgt_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(x, zero), xScale),
+                                  _mm_mullo_epi16(_mm_unpacklo_epi8(y, zero), yScale));
+    __m128i high = _mm_cmpgt_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(x, zero), xScale),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(y, zero), yScale));
+    return _mm_packs_epi16(low, high);
+}
+
+static inline __m128i zeroBelow(__m128i x, __m128i threshold)
+{
+    return _mm_and_si128(x, _mm_cmpeq_epi8(_mm_max_epu8(x, threshold), x));
+}
+
+/// Classifies 16 pixels per iteration.
+/// @return Number of classified pixels
+static int classifyRowSIMD(const uint8_t *pixels, int width, ColorSpace colorSpace, uint8_t *red, uint8_t *green, uint8_t *blue)
+{
+    const int bytesPerPixel = colorSpace == ColorSpaceBGRA ? 4 : 3;
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i threshold = _mm_set1_epi8(darkThreshold);
+    const __m128i two = _mm_set1_epi16(2);
+    const __m128i three = _mm_set1_epi16(3);
+    const __m128i five = _mm_set1_epi16(5);
+    const __m128i six = _mm_set1_epi16(6);
+    const __m128i nine = _mm_set1_epi16(9);
+    
+    int j = 0;
+    for (; j + 16 <= width; j += 16) {
+        __m128i r, g, b;
+        deinterleave(pixels + j * bytesPerPixel, colorSpace, r, g, b);
+        
+        __m128i isRed = _mm_and_si128(greaterScaled(r, g, five, nine), greaterScaled(r, b, five, nine));
+        r = zeroBelow(r, threshold);
+        __m128i isGreen = _mm_and_si128(greaterScaled(g, r, five, six), greaterScaled(g, b, five, six));
+        g = zeroBelow(g, threshold);
+        __m128i isBlue = _mm_and_si128(greaterScaled(b, g, two, three), greaterScaled(b, r, two, three));
+        
+        _mm_storeu_si128((__m128i *)(red + j), _mm_and_si128(isRed, one));
+        _mm_storeu_si128((__m128i *)(green + j), _mm_and_si128(isGreen, one));
+        _mm_storeu_si128((__m128i *)(blue + j), _mm_and_si128(isBlue, one));
+    }
+    return j;
+}
+
+// MARK: - NEON
+
+#elif defined(__ARM_NEON)
+
+/// Returns 0xFF for pixels where x * xScale > y * yScale.
+static inline uint8x16_t greaterScaled(uint8x16_t x, uint8x16_t y, uint8x8_t xScale, uint8x8_t yScale)
+{
+    uint16x8_t low = vcgtq_u16(vmull_u8(vget_low_u8(x), xScale), vmull_u8(vget_low_u8(y), yScale));
+    uint16x8_t high = vcgtq_u16(vmull_u8(vget_high_u8(x), xScale), vmull_u8(vget_high_u8(y), yScale));
+    return vcombine_u8(vmovn_u16(low), vmovn_u16(high));
+}
+
+static inline uint8x16_t zeroBelow(uint8x16_t x, uint8x16_t threshold)
+{
+    return vandq_u8(x, vcgeq_u8(x, threshold));
+}
+
+/// Classifies 16 pixels per iteration.
+/// @return Number of classified pixels
+static int classifyRowSIMD(const uint8_t *pixels, int width, ColorSpace colorSpace, uint8_t *red, uint8_t *green, uint8_t *blue)
+{
+    const uint8x16_t one = vdupq_n_u8(1);
+    const uint8x16_t threshold = vdupq_n_u8(darkThreshold);
+    const uint8x8_t two = vdup_n_u8(2);
+    const uint8x8_t three = vdup_n_u8(3);
+    const uint8x8_t five = vdup_n_u8(5);
+    const uint8x8_t six = vdup_n_u8(6);
+    const uint8x8_t nine = vdup_n_u8(9);
+    
+    int j = 0;
+    for (; j + 16 <= width; j += 16) {
+        uint8x16_t r, g, b;
+        if (colorSpace == ColorSpaceBGRA) {
+            uint8x16x4_t channels = vld4q_u8(pixels + j * 4);
+            b = channels.val[0];
+            g = channels.val[1];
+            r = channels.val[2];
+        } else {
+            uint8x16x3_t channels = vld3q_u8(pixels + j * 3);
+            r = channels.val[0];
+            g = channels.val[1];
+            b = channels.val[2];
+        }
+        
+        uint8x16_t isRed = vandq_u8(greaterScaled(r, g, five, nine), greaterScaled(r, b, five, nine));
+        r = zeroBelow(r, threshold);
+        uint8x16_t isGreen = vandq_u8(greaterScaled(g, r, five, six), greaterScaled(g, b, five, six));
+        g = zeroBelow(g, threshold);
+        uint8x16_t isBlue = vandq_u8(greaterScaled(b, g, two, three), greaterScaled(b, r, two, three));
+        
+        vst1q_u8(red + j, vandq_u8(isRed, one));
+        vst1q_u8(green + j, vandq_u8(isGreen, one));
+        vst1q_u8(blue + j, vandq_u8(isBlue, one));
+    }
+    return j;
+}
+
+#else
+
+static int classifyRowSIMD(const uint8_t *, int, ColorSpace, uint8_t *, uint8_t *, uint8_t *)
+{
+    return 0;
+}
+
+#endif
+
+// MARK: - Implementation
+
+/// Classifies a pixel from its red, green and blue channels, all scaled by `scale`.
+static inline void classifyPixel(int r, int g, int b, int scale, uint8_t &red, uint8_t &green, uint8_t &blue)
+{
+    red = 5 * r > 9 * g && 5 * r > 9 * b;
+    
+    if (r < darkThreshold * scale) {
+        r = 0;
+    }
+    green = 5 * g > 6 * r && 5 * g > 6 * b;
+    
+    if (g < darkThreshold * scale) {
+        g = 0;
+    }
+    blue = 2 * b > 3 * g && 2 * b > 3 * r;
+}
+
+void ColorClassifier::classifyRowScalar(const uint8_t *pixels, int width, ColorSpace colorSpace, uint8_t *red, uint8_t *green, uint8_t *blue)
+{
+    if (isYUV(colorSpace)) {
+        for (int j = 0; j < width; j++, pixels += 3) {
+            int y = pixels[0] * yuvScale;
+            int u = pixels[1] - 128;
+            int v = pixels[2] - 128;
+            
+            classifyPixel(y + vToRed * v, y - uToGreen * u - vToGreen * v, y + uToBlue * u, yuvScale, red[j], green[j], blue[j]);
+        }
+        return;
+    }
+    
+    if (isBayer(colorSpace)) {
+        // Quads are R, G, G, B or B, G, G, R
+        int redIndex = colorSpace == ColorSpaceBayerRGGB ? 0 : 3;
+        int blueIndex = 3 - redIndex;
+        for (int j = 0; j < width; j++, pixels += 4) {
+            classifyPixel(pixels[redIndex] * 2, pixels[1] + pixels[2], pixels[blueIndex] * 2, 2, red[j], green[j], blue[j]);
+        }
+        return;
+    }
+    
+    int redIndex = 0;
+    int greenIndex = 1;
+    int blueIndex = 2;
+    int bytesPerPixel = 3;
+    
+    if (colorSpace == ColorSpaceBGRA) {
+        redIndex = 2;
+        blueIndex = 0;
+        bytesPerPixel = 4;
+    }
+    
+    for (int j = 0; j < width; j++, pixels += bytesPerPixel) {
+        classifyPixel(pixels[redIndex], pixels[greenIndex], pixels[blueIndex], 1, red[j], green[j], blue[j]);
+    }
+}
+
+void ColorClassifier::classifyRow(const uint8_t *pixels, int width, ColorSpace colorSpace, uint8_t *red, uint8_t *green, uint8_t *blue)
+{
+    int bytesPerPixel = colorSpace == ColorSpaceBGRA || isBayer(colorSpace) ? 4 : 3;
+    // YUV and Bayer frames are small eye crops, they are classified by the scalar kernel only
+    int j = isYUV(colorSpace) || isBayer(colorSpace) ? 0 : classifyRowSIMD(pixels, width, colorSpace, red, green, blue);
+    classifyRowScalar(pixels + j * bytesPerPixel, width - j, colorSpace, red + j, green + j, blue + j);
+}
+
+void ColorClassifier::classify(const cv::Mat &frame, ColorSpace colorSpace, cv::Mat masks[numberOfColors])
+{
+    for (int color = 0; color < numberOfColors; color++) {
+        masks[color].create(frame.rows, frame.cols, CV_8UC1);
+    }
+    
+    // Continuous frame is processed as one long row, so SIMD kernels don't stop at the end of each row
+    int rows = frame.rows;
+    int width = frame.cols;
+    if (frame.isContinuous()) {
+        width *= rows;
+        rows = 1;
+    }
+    
+    for (int i = 0; i < rows; i++) {
+        classifyRow(frame.ptr<uint8_t>(i), width, colorSpace,
+                    masks[ColorRed].ptr<uint8_t>(i), masks[ColorGreen].ptr<uint8_t>(i), masks[ColorBlue].ptr<uint8_t>(i));
+    }
+}
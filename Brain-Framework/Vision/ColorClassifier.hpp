@@ -0,0 +1,53 @@
+//
+//  ColorClassifier.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef ColorClassifier_hpp
+#define ColorClassifier_hpp
+
+#include <iostream>
+#include <opencv2/opencv.hpp>
+
+#include "../Models/ColorSpace.h"
+#include "../Models/ColorType.hpp"
+
+/// Classifies pixels by dominant color.
+/// Pixel is red if red channel is 1.8 times bigger than both green and blue channels, green if 1.2 times bigger than
+/// red and blue and blue if 1.5 times bigger than red and green. Red and green channels below 50 are treated as 0 when
+/// testing the colors which follow them.
+/// Tests are done in fixed-point integer math, which is exact for 8-bit channels. Rows are processed with AVX2, SSSE3
+/// or NEON kernels when the target supports them, the scalar kernel is the reference and handles the remaining pixels.
+/// Frames of YUV color spaces are interleaved Y, U and V. They are classified without conversion to RGB, tests become
+/// linear forms of Y, U and V, so they differ from converted frames only for colors outside of RGB gamut.
+/// Frames of Bayer color spaces are 2x2 quads interleaved in 4 channels, top row first. Green of a quad is the mean
+/// of its two green samples, tests are done on doubled channels so the mean stays exact.
+class ColorClassifier {
+public:
+    
+    /// Number of classified colors, see `ColorType.hpp`
+    static const int numberOfColors = 3;
+    
+    /// Classifies all colors in a single pass over the frame.
+    /// @param frame Frame in given color space, 3 interleaved channels for YUV and 4 for Bayer color spaces
+    /// @param colorSpace Color space of frame, see `ColorSpace.h`
+    /// @param masks Output masks indexed by `ColorType`, 1 for pixels of that color, reallocated only if frame size changes
+    static void classify(const cv::Mat &frame, ColorSpace colorSpace, cv::Mat masks[numberOfColors]);
+    
+    /// Classifies one row of pixels with the fastest available kernel.
+    /// @param pixels Pixels in given color space
+    /// @param width Number of pixels
+    /// @param colorSpace Color space of frame, 3 interleaved channels for YUV and 4 for Bayer color spaces
+    /// @param red Output mask of red pixels
+    /// @param green Output mask of green pixels
+    /// @param blue Output mask of blue pixels
+    static void classifyRow(const uint8_t *pixels, int width, ColorSpace colorSpace, uint8_t *red, uint8_t *green, uint8_t *blue);
+    
+    /// Reference scalar implementation of `classifyRow`.
+    static void classifyRowScalar(const uint8_t *pixels, int width, ColorSpace colorSpace, uint8_t *red, uint8_t *green, uint8_t *blue);
+};
+
+#endif /* ColorClassifier_hpp */
@@ -0,0 +1,122 @@
+//
+//  DnnFeatureExtractor.cpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "DnnFeatureExtractor.hpp"
+
+int DnnFeatureExtractor::numberOfFeatures()
+{
+    return (int)outputIndices.size();
+}
+
+void DnnFeatureExtractor::setPreprocessing(double scaleFactor_, cv::Scalar mean_, bool rgb)
+{
+    scaleFactor = scaleFactor_;
+    mean = mean_;
+    swapRB = rgb;
+}
+
+#ifdef HAVE_OPENCV_DNN
+
+int DnnFeatureExtractor::load(std::string modelPath, std::string configPath, std::vector<int> outputIndices_, double activationScale_)
+{
+    try {
+        net = cv::dnn::readNet(modelPath, configPath);
+    } catch (const std::exception &e) {
+        std::cout << "Can't load network: " << e.what() << std::endl;
+        return 1;
+    }
+    if (net.empty()) {
+        return 1;
+    }
+    net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+    
+    outputIndices = outputIndices_;
+    activationScale = activationScale_;
+    return 0;
+}
+
+int DnnFeatureExtractor::extract(const std::vector<cv::Mat> &frames, ColorSpace colorSpace, std::vector<std::vector<double>> &features)
+{
+    if (net.empty() || frames.empty()) {
+        return 1;
+    }
+    
+    // Network takes BGR
+    inputs.resize(frames.size());
+    for (size_t i = 0; i < frames.size(); i++) {
+        switch (colorSpace) {
+            case ColorSpaceRGB:
+                cv::cvtColor(frames[i], inputs[i], cv::COLOR_RGB2BGR);
+                break;
+            case ColorSpaceBGRA:
+                cv::cvtColor(frames[i], inputs[i], cv::COLOR_BGRA2BGR);
+                break;
+            case ColorSpaceBayerRGGB:
+            case ColorSpaceBayerBGGR: {
+                // Eye frames of Bayer color spaces are quads, green is the mean of both green samples
+                int redIndex = colorSpace == ColorSpaceBayerRGGB ? 0 : 3;
+                inputs[i].create(frames[i].size(), CV_8UC3);
+                for (int y = 0; y < frames[i].rows; y++) {
+                    const uint8_t *quad = frames[i].ptr<uint8_t>(y);
+                    uint8_t *pixel = inputs[i].ptr<uint8_t>(y);
+                    for (int x = 0; x < frames[i].cols; x++, quad += 4, pixel += 3) {
+                        pixel[0] = quad[3 - redIndex];
+                        pixel[1] = (uint8_t)((quad[1] + quad[2] + 1) / 2);
+                        pixel[2] = quad[redIndex];
+                    }
+                }
+                break;
+            }
+            default: {
+                // Eye frames of YUV color spaces are Y, U, V, OpenCV takes Y, Cr, Cb
+                yCrCb.create(frames[i].size(), CV_8UC3);
+                int fromTo[] = { 0, 0, 1, 2, 2, 1 };
+                cv::mixChannels(&frames[i], 1, &yCrCb, 1, fromTo, 3);
+                cv::cvtColor(yCrCb, inputs[i], cv::COLOR_YCrCb2BGR);
+                break;
+            }
+        }
+    }
+    
+    try {
+        // All eyes in one forward pass
+        cv::dnn::blobFromImages(inputs, blob, scaleFactor, cv::Size(), mean, swapRB, false);
+        net.setInput(blob);
+        cv::Mat output = net.forward();
+        cv::Mat activations = output.reshape(1, (int)frames.size());
+        
+        features.resize(outputIndices.size());
+        for (size_t k = 0; k < outputIndices.size(); k++) {
+            features[k].resize(frames.size());
+            for (int eye = 0; eye < (int)frames.size(); eye++) {
+                int index = outputIndices[k];
+                features[k][eye] = index < activations.cols ? activations.at<float>(eye, index) * activationScale : 0;
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cout << "Feature extraction failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#else
+
+int DnnFeatureExtractor::load(std::string, std::string, std::vector<int>, double)
+{
+    std::cout << "OpenCV is built without dnn module" << std::endl;
+    return 1;
+}
+
+int DnnFeatureExtractor::extract(const std::vector<cv::Mat> &, ColorSpace, std::vector<std::vector<double>> &)
+{
+    return 1;
+}
+
+#endif
@@ -0,0 +1,63 @@
+//
+//  DnnFeatureExtractor.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef DnnFeatureExtractor_hpp
+#define DnnFeatureExtractor_hpp
+
+#include <iostream>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#ifdef HAVE_OPENCV_DNN
+    #include <opencv2/dnn.hpp>
+#endif
+
+#include "FeatureExtractor.hpp"
+
+/// Features from output activations of a neural network run by `cv::dnn` on CPU.
+/// Eye frames are batched into one forward pass. Frames are given to the network as BGR after `scaleFactor` and
+/// `mean` are applied, the way Caffe ImageNet models expect, see `setPreprocessing` for other models.
+class DnnFeatureExtractor : public FeatureExtractor {
+    
+#ifdef HAVE_OPENCV_DNN
+    cv::dnn::Net net;
+#endif
+    std::vector<int> outputIndices;
+    double activationScale = 1;
+    
+    double scaleFactor = 1;
+    cv::Scalar mean = cv::Scalar(104, 117, 123);
+    bool swapRB = false;
+    
+    /// Preprocessing buffers, reused between frames
+    std::vector<cv::Mat> inputs;
+    cv::Mat yCrCb;
+    cv::Mat blob;
+    
+public:
+    
+    /// Loads network.
+    /// @param modelPath Path to model, e.g. *.onnx or *.caffemodel
+    /// @param configPath Path to network description, e.g. *.prototxt, empty if model doesn't need it
+    /// @param outputIndices_ Indices of activations in flattened network output used as features
+    /// @param activationScale_ Factor activations are multiplied with
+    /// @return Non zero value indicates to occurred error
+    int load(std::string modelPath, std::string configPath, std::vector<int> outputIndices_, double activationScale_);
+    
+    /// Set preprocessing of frames, same as in `cv::dnn::blobFromImages`.
+    /// @param scaleFactor_ Factor pixel values are multiplied with after mean is subtracted
+    /// @param mean_ Mean subtracted from channels, in network channel order
+    /// @param rgb Whether network takes RGB instead of BGR
+    void setPreprocessing(double scaleFactor_, cv::Scalar mean_, bool rgb);
+    
+    int numberOfFeatures() override;
+    
+    int extract(const std::vector<cv::Mat> &frames, ColorSpace colorSpace, std::vector<std::vector<double>> &features) override;
+};
+
+#endif /* DnnFeatureExtractor_hpp */
@@ -0,0 +1,59 @@
+//
+//  Eye.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef Eye_hpp
+#define Eye_hpp
+
+#include <iostream>
+#include <opencv2/opencv.hpp>
+
+#include "../Models/Score.hpp"
+#include "../Models/ColorSpace.h"
+#include "ColorClassifier.hpp"
+#include "BlobDetector.hpp"
+#include "EyeResampler.hpp"
+#include "FrameSignature.hpp"
+#include "FluidEyePipeline.hpp"
+#include "MotionDetector.hpp"
+
+/// Working buffers and results of one camera's vision pipeline.
+/// Every eye owns its buffers, so eyes can be processed concurrently and buffers are reused between frames.
+class Eye {
+public:
+    
+    /// Samples of camera frame crop, used to skip unchanged frames
+    FrameSignature signature;
+    
+    /// Crop of camera frame resized to network input size
+    cv::Mat frame;
+    /// Color space of `frame`, interleaved planes of NV12 and I420 frames are in the same order
+    ColorSpace colorSpace = ColorSpaceRGB;
+    
+    /// Resamplers and resampled planes of planar frames, see `ColorSpace.h`
+    /// Frames with interleaved channels use only the first resampler.
+    static const int maxNumberOfPlanes = 3;
+    EyeResampler resamplers[maxNumberOfPlanes];
+    cv::Mat planes[maxNumberOfPlanes];
+    
+    /// Alternative to resamplers and classification, `frame` isn't filled when it's used
+    FluidEyePipeline fluidPipeline;
+    
+    /// Color masks of `frame`, indexed by `ColorType`
+    cv::Mat colorMasks[ColorClassifier::numberOfColors];
+    /// Blob detectors indexed by `ColorType`, each keeps tracking state of its color
+    BlobDetector blobDetectors[ColorClassifier::numberOfColors];
+    
+    /// Scores of last processed frame, indexed by `ColorType`
+    Score scores[ColorClassifier::numberOfColors];
+    
+    /// Motion energy of `frame` and its scores, indexed by band, see `MotionDetector`
+    MotionDetector motionDetector;
+    double motionScores[MotionDetector::numberOfBands] = {};
+};
+
+#endif /* Eye_hpp */
@@ -0,0 +1,147 @@
+//
+//  EyeResampler.cpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "EyeResampler.hpp"
+
+static const int weightBits = 8;
+static const int weightScale = 1 << weightBits;
+
+/// Fills source index and fixed-point weights of the following pixel, the same way `cv::resize` maps coordinates.
+static void mapCoordinate(int destination, double scale, int sourceSize, int &index, uint16_t &weight)
+{
+    double position = (destination + 0.5) * scale - 0.5;
+    index = (int)floor(position);
+    double fraction = position - index;
+    
+    if (index < 0) {
+        index = 0;
+        fraction = 0;
+    }
+    if (index >= sourceSize - 1) {
+        index = sourceSize - 1;
+        fraction = 0;
+    }
+    weight = (uint16_t)round(fraction * weightScale);
+}
+
+void EyeResampler::prepare(cv::Rect crop_, cv::Size outputSize_, int channels_)
+{
+    crop = crop_;
+    outputSize = outputSize_;
+    channels = channels_;
+    
+    xOffsets.resize(outputSize.width * 2);
+    xWeights.resize(outputSize.width * 2);
+    yRows.resize(outputSize.height * 2);
+    yWeights.resize(outputSize.height * 2);
+    rowBuffers[0].resize(outputSize.width * channels);
+    rowBuffers[1].resize(outputSize.width * channels);
+    
+    double scaleX = (double)crop.width / outputSize.width;
+    for (int x = 0; x < outputSize.width; x++) {
+        int index;
+        uint16_t weight;
+        mapCoordinate(x, scaleX, crop.width, index, weight);
+        xOffsets[x * 2] = index * channels;
+        xOffsets[x * 2 + 1] = std::min(index + 1, crop.width - 1) * channels;
+        xWeights[x * 2] = weightScale - weight;
+        xWeights[x * 2 + 1] = weight;
+    }
+    
+    double scaleY = (double)crop.height / outputSize.height;
+    for (int y = 0; y < outputSize.height; y++) {
+        int index;
+        uint16_t weight;
+        mapCoordinate(y, scaleY, crop.height, index, weight);
+        yRows[y * 2] = index;
+        yRows[y * 2 + 1] = std::min(index + 1, crop.height - 1);
+        yWeights[y * 2] = weightScale - weight;
+        yWeights[y * 2 + 1] = weight;
+    }
+}
+
+void EyeResampler::resampleRow(const uint8_t *source, int *row)
+{
+    for (int x = 0; x < outputSize.width; x++) {
+        const uint8_t *left = source + xOffsets[x * 2];
+        const uint8_t *right = source + xOffsets[x * 2 + 1];
+        int leftWeight = xWeights[x * 2];
+        int rightWeight = xWeights[x * 2 + 1];
+        for (int c = 0; c < channels; c++) {
+            row[x * channels + c] = left[c] * leftWeight + right[c] * rightWeight;
+        }
+    }
+}
+
+void EyeResampler::resample(const cv::Mat &source, cv::Rect crop_, cv::Mat &output, cv::Size outputSize_)
+{
+    if (crop_ != crop || outputSize_ != outputSize || source.channels() != channels) {
+        prepare(crop_, outputSize_, source.channels());
+    }
+    output.create(outputSize, source.type());
+    
+    const int rowLength = outputSize.width * channels;
+    // Rows already held in buffers, consecutive output rows often share source rows
+    int bufferedRows[2] = { -1, -1 };
+    
+    for (int y = 0; y < outputSize.height; y++) {
+        int topRow = yRows[y * 2];
+        int bottomRow = yRows[y * 2 + 1];
+        
+        if (bufferedRows[0] != topRow) {
+            if (bufferedRows[1] == topRow) {
+                rowBuffers[0].swap(rowBuffers[1]);
+                std::swap(bufferedRows[0], bufferedRows[1]);
+            } else {
+                resampleRow(source.ptr<uint8_t>(crop.y + topRow) + crop.x * channels, rowBuffers[0].data());
+                bufferedRows[0] = topRow;
+            }
+        }
+        if (bufferedRows[1] != bottomRow) {
+            if (bottomRow == topRow) {
+                std::copy(rowBuffers[0].begin(), rowBuffers[0].end(), rowBuffers[1].begin());
+            } else {
+                resampleRow(source.ptr<uint8_t>(crop.y + bottomRow) + crop.x * channels, rowBuffers[1].data());
+            }
+            bufferedRows[1] = bottomRow;
+        }
+        
+        const int *top = rowBuffers[0].data();
+        const int *bottom = rowBuffers[1].data();
+        int topWeight = yWeights[y * 2];
+        int bottomWeight = yWeights[y * 2 + 1];
+        uint8_t *destination = output.ptr<uint8_t>(y);
+        for (int i = 0; i < rowLength; i++) {
+            destination[i] = (uint8_t)((top[i] * topWeight + bottom[i] * bottomWeight + (1 << (weightBits * 2 - 1))) >> (weightBits * 2));
+        }
+    }
+}
+
+void EyeResampler::interleave(const cv::Mat *planes, int numberOfPlanes, cv::Mat &output)
+{
+    int outputChannels = 0;
+    for (int p = 0; p < numberOfPlanes; p++) {
+        outputChannels += planes[p].channels();
+    }
+    output.create(planes[0].size(), CV_8UC(outputChannels));
+    
+    for (int y = 0; y < output.rows; y++) {
+        uint8_t *destination = output.ptr<uint8_t>(y);
+        int channel = 0;
+        for (int p = 0; p < numberOfPlanes; p++) {
+            const uint8_t *source = planes[p].ptr<uint8_t>(y);
+            int channels = planes[p].channels();
+            for (int x = 0; x < output.cols; x++) {
+                for (int c = 0; c < channels; c++) {
+                    destination[x * outputChannels + channel + c] = source[x * channels + c];
+                }
+            }
+            channel += channels;
+        }
+    }
+}
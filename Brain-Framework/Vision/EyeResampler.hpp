@@ -0,0 +1,56 @@
+//
+//  EyeResampler.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef EyeResampler_hpp
+#define EyeResampler_hpp
+
+#include <iostream>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+/// Crops and resizes a camera frame in one bilinear pass.
+/// Source positions follow `cv::resize` with `INTER_LINEAR`, weights are 8-bit fixed-point. Interpolation tables and
+/// row buffers are kept between calls and rebuilt only when crop, output size or pixel format changes, so steady state
+/// resampling doesn't allocate.
+class EyeResampler {
+    
+    cv::Rect crop;
+    cv::Size outputSize;
+    int channels = 0;
+    
+    /// Byte offsets of left source pixel within the crop row, per output column
+    std::vector<int> xOffsets;
+    /// Weights of left and right source pixels, per output column
+    std::vector<uint16_t> xWeights;
+    /// Crop rows of top and bottom source pixels, per output row
+    std::vector<int> yRows;
+    /// Weights of top and bottom source pixels, per output row
+    std::vector<uint16_t> yWeights;
+    /// Horizontally interpolated top and bottom rows
+    std::vector<int> rowBuffers[2];
+    
+    void prepare(cv::Rect crop, cv::Size outputSize, int channels);
+    void resampleRow(const uint8_t *source, int *row);
+    
+public:
+    
+    /// Resamples `crop` of `source` into `output`.
+    /// @param source Camera frame of type `CV_8UC3` or `CV_8UC4`
+    /// @param crop Region of source, has to lie within it
+    /// @param output Output frame, reallocated only if its size or type differs
+    /// @param outputSize Size of output frame
+    void resample(const cv::Mat &source, cv::Rect crop, cv::Mat &output, cv::Size outputSize);
+    
+    /// Interleaves channels of resampled planes into one frame.
+    /// @param planes Planes of the same size
+    /// @param numberOfPlanes Number of planes
+    /// @param output Output frame with channels of all planes, reallocated only if its size or type differs
+    static void interleave(const cv::Mat *planes, int numberOfPlanes, cv::Mat &output);
+};
+
+#endif /* EyeResampler_hpp */
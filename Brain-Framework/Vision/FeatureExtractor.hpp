@@ -0,0 +1,36 @@
+//
+//  FeatureExtractor.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef FeatureExtractor_hpp
+#define FeatureExtractor_hpp
+
+#include <iostream>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "../Models/ColorSpace.h"
+
+/// Computes visual features of eye frames, every feature becomes a row of visual preference values which follows the
+/// color rows. Extractors run on their own thread, away from the neural loop.
+class FeatureExtractor {
+public:
+    
+    virtual ~FeatureExtractor() {}
+    
+    /// Number of features of one eye.
+    virtual int numberOfFeatures() = 0;
+    
+    /// Extracts features of all eyes at once.
+    /// @param frames Eye frames in given color space, see `Eye`
+    /// @param colorSpace Color space of frames, see `ColorSpace.h`
+    /// @param features Output values indexed by feature and eye
+    /// @return Non zero value indicates to occurred error
+    virtual int extract(const std::vector<cv::Mat> &frames, ColorSpace colorSpace, std::vector<std::vector<double>> &features) = 0;
+};
+
+#endif /* FeatureExtractor_hpp */
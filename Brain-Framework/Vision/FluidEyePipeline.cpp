@@ -0,0 +1,138 @@
+//
+//  FluidEyePipeline.cpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "FluidEyePipeline.hpp"
+
+#ifdef HAVE_OPENCV_GAPI
+
+#include <opencv2/gapi/core.hpp>
+#include <opencv2/gapi/fluid/core.hpp>
+#include <opencv2/gapi/fluid/gfluidkernel.hpp>
+
+// MARK: - Kernels
+
+/// Reorders BGRA pixels to RGB, Fluid resize works with 3 channels.
+G_TYPED_KERNEL(GBGRAToRGB, <cv::GMat(cv::GMat)>, "org.backyardbrains.vision.bgraToRgb") {
+    static cv::GMatDesc outMeta(cv::GMatDesc in) {
+        return in.withType(CV_8U, 3);
+    }
+};
+
+typedef std::tuple<cv::GMat, cv::GMat, cv::GMat> GMasks;
+typedef std::tuple<cv::GMatDesc, cv::GMatDesc, cv::GMatDesc> GMasksDesc;
+
+/// Classifies colors, see `ColorClassifier`.
+G_TYPED_KERNEL_M(GClassifyColors, <GMasks(cv::GMat, int)>, "org.backyardbrains.vision.classifyColors") {
+    static GMasksDesc outMeta(cv::GMatDesc in, int) {
+        cv::GMatDesc mask = in.withType(CV_8U, 1);
+        return std::make_tuple(mask, mask, mask);
+    }
+};
+
+GAPI_FLUID_KERNEL(GFluidBGRAToRGB, GBGRAToRGB, false) {
+    static const int Window = 1;
+    
+    static void run(const cv::gapi::fluid::View &in, cv::gapi::fluid::Buffer &out)
+    {
+        const uint8_t *source = in.InLine<uint8_t>(0);
+        uint8_t *destination = out.OutLine<uint8_t>();
+        for (int x = 0; x < in.length(); x++) {
+            destination[x * 3] = source[x * 4 + 2];
+            destination[x * 3 + 1] = source[x * 4 + 1];
+            destination[x * 3 + 2] = source[x * 4];
+        }
+    }
+};
+
+GAPI_FLUID_KERNEL(GFluidClassifyColors, GClassifyColors, false) {
+    static const int Window = 1;
+    
+    static void run(const cv::gapi::fluid::View &in, int colorSpace, cv::gapi::fluid::Buffer &red, cv::gapi::fluid::Buffer &green, cv::gapi::fluid::Buffer &blue)
+    {
+        ColorClassifier::classifyRow(in.InLine<uint8_t>(0), in.length(), (ColorSpace)colorSpace,
+                                     red.OutLine<uint8_t>(), green.OutLine<uint8_t>(), blue.OutLine<uint8_t>());
+    }
+};
+
+// MARK: - Pipeline
+
+int FluidEyePipeline::compile(const cv::Mat &crop, ColorSpace colorSpace, cv::Size outputSize)
+{
+    isCompiled = false;
+    compileFailed = true;
+    compiledCropSize = crop.size();
+    compiledOutputSize = outputSize;
+    compiledColorSpace = colorSpace;
+    
+    cv::GMat in;
+    cv::GMat rgb = colorSpace == ColorSpaceBGRA ? GBGRAToRGB::on(in) : in;
+    cv::GMat resized = cv::gapi::resize(rgb, outputSize, 0, 0, cv::INTER_LINEAR);
+    cv::GMat red, green, blue;
+    std::tie(red, green, blue) = GClassifyColors::on(resized, (int)ColorSpaceRGB);
+    cv::GComputation computation(cv::GIn(in), cv::GOut(red, green, blue));
+    
+    auto kernels = cv::gapi::combine(cv::gapi::core::fluid::kernels(),
+                                     cv::gapi::kernels<GFluidBGRAToRGB, GFluidClassifyColors>());
+    try {
+        compiled = computation.compile(cv::GMetaArgs{ cv::GMetaArg(cv::descr_of(crop)) }, cv::compile_args(kernels));
+    } catch (const std::exception &e) {
+        std::cout << "Fluid vision pipeline isn't available: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    isCompiled = true;
+    compileFailed = false;
+    return 0;
+}
+
+bool FluidEyePipeline::supports(ColorSpace colorSpace)
+{
+    return colorSpace == ColorSpaceRGB || colorSpace == ColorSpaceBGRA;
+}
+
+int FluidEyePipeline::process(const cv::Mat &source, cv::Rect crop, ColorSpace colorSpace, cv::Size outputSize, cv::Mat masks[ColorClassifier::numberOfColors])
+{
+    if (!supports(colorSpace)) {
+        return 1;
+    }
+    
+    // Crop is only a view of camera frame
+    cv::Mat cropView = source(crop);
+    
+    bool configurationChanged = cropView.size() != compiledCropSize || outputSize != compiledOutputSize || colorSpace != compiledColorSpace;
+    if (configurationChanged || (!isCompiled && !compileFailed)) {
+        int error = compile(cropView, colorSpace, outputSize);
+        if (error) {
+            return error;
+        }
+    } else if (compileFailed) {
+        return 1;
+    }
+    
+    try {
+        compiled(cv::gin(cropView), cv::gout(masks[ColorRed], masks[ColorGreen], masks[ColorBlue]));
+    } catch (const std::exception &e) {
+        std::cout << "Fluid vision pipeline failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#else
+
+bool FluidEyePipeline::supports(ColorSpace)
+{
+    return false;
+}
+
+int FluidEyePipeline::process(const cv::Mat &, cv::Rect, ColorSpace, cv::Size, cv::Mat [ColorClassifier::numberOfColors])
+{
+    return 1;
+}
+
+#endif
@@ -0,0 +1,57 @@
+//
+//  FluidEyePipeline.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef FluidEyePipeline_hpp
+#define FluidEyePipeline_hpp
+
+#include <iostream>
+#include <opencv2/opencv.hpp>
+
+#ifdef HAVE_OPENCV_GAPI
+    #include <opencv2/gapi.hpp>
+#endif
+
+#include "../Models/ColorSpace.h"
+#include "ColorClassifier.hpp"
+
+/// Eye vision stages as a G-API graph executed by the Fluid backend.
+/// Crop is taken as a view of camera frame, resize and color classification run line by line, so intermediate images
+/// never exist as whole frames. Graph is compiled on the first frame and again only when crop size, color space or
+/// output size changes.
+/// Available only when OpenCV is built with G-API and for `ColorSpaceRGB` and `ColorSpaceBGRA`.
+class FluidEyePipeline {
+    
+#ifdef HAVE_OPENCV_GAPI
+    cv::GCompiled compiled;
+    bool isCompiled = false;
+    /// Set if compilation for the current sizes and color space failed, so it isn't retried every frame
+    bool compileFailed = false;
+    cv::Size compiledCropSize;
+    cv::Size compiledOutputSize;
+    ColorSpace compiledColorSpace = ColorSpaceRGB;
+    
+    /// @return Non zero value indicates to occurred error
+    int compile(const cv::Mat &crop, ColorSpace colorSpace, cv::Size outputSize);
+#endif
+    
+public:
+    
+    /// Returns whether frames in given color space can be processed.
+    static bool supports(ColorSpace colorSpace);
+    
+    /// Crops, resizes and classifies colors of camera frame.
+    /// @param source Camera frame
+    /// @param crop Region of source, has to lie within it
+    /// @param colorSpace Color space of source, see `ColorSpace.h`
+    /// @param outputSize Size of masks
+    /// @param masks Output masks indexed by `ColorType`, see `ColorClassifier`
+    /// @return Non zero value indicates to occurred error
+    int process(const cv::Mat &source, cv::Rect crop, ColorSpace colorSpace, cv::Size outputSize, cv::Mat masks[ColorClassifier::numberOfColors]);
+};
+
+#endif /* FluidEyePipeline_hpp */
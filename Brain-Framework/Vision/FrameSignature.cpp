@@ -0,0 +1,49 @@
+//
+//  FrameSignature.cpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "FrameSignature.hpp"
+
+void FrameSignature::sample(const cv::Mat *planes, const cv::Rect *crops, int numberOfPlanes)
+{
+    int rowLength = 0;
+    for (int p = 0; p < numberOfPlanes; p++) {
+        rowLength += gridSize * planes[p].channels();
+    }
+    samples.create(gridSize, rowLength, CV_8UC1);
+    
+    for (int i = 0; i < gridSize; i++) {
+        uint8_t *destination = samples.ptr<uint8_t>(i);
+        for (int p = 0; p < numberOfPlanes; p++) {
+            const cv::Rect &crop = crops[p];
+            int channels = planes[p].channels();
+            // Samples are in the middle of grid cells
+            const uint8_t *row = planes[p].ptr<uint8_t>(crop.y + (2 * i + 1) * crop.height / (2 * gridSize));
+            for (int j = 0; j < gridSize; j++) {
+                const uint8_t *pixel = row + (crop.x + (2 * j + 1) * crop.width / (2 * gridSize)) * channels;
+                for (int c = 0; c < channels; c++) {
+                    *destination++ = pixel[c];
+                }
+            }
+        }
+    }
+}
+
+double FrameSignature::difference()
+{
+    if (!hasProcessedSamples || processedSamples.size() != samples.size()) {
+        return 255;
+    }
+    // Vectorized by OpenCV
+    return cv::norm(samples, processedSamples, cv::NORM_L1) / samples.total();
+}
+
+void FrameSignature::markProcessed()
+{
+    samples.copyTo(processedSamples);
+    hasProcessedSamples = true;
+}
@@ -0,0 +1,43 @@
+//
+//  FrameSignature.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef FrameSignature_hpp
+#define FrameSignature_hpp
+
+#include <iostream>
+#include <opencv2/opencv.hpp>
+
+/// Cheap test whether a region of camera frames changed.
+/// Pixels on a sparse grid of the region are sampled and compared with samples of the last frame marked as
+/// processed, so slow changes add up until they are noticed.
+class FrameSignature {
+    
+    cv::Mat samples;
+    cv::Mat processedSamples;
+    bool hasProcessedSamples = false;
+    
+public:
+    
+    /// Number of sampled rows and columns of every plane
+    static const int gridSize = 32;
+    
+    /// Samples regions of all planes of a frame.
+    /// @param planes Planes of frame
+    /// @param crops Sampled region of each plane
+    /// @param numberOfPlanes Number of planes
+    void sample(const cv::Mat *planes, const cv::Rect *crops, int numberOfPlanes);
+    
+    /// Returns mean absolute difference of the last samples from the samples marked as processed.
+    /// @return Difference in range [0, 255], 255 if there are no comparable processed samples
+    double difference();
+    
+    /// Keeps the last samples as reference for following frames.
+    void markProcessed();
+};
+
+#endif /* FrameSignature_hpp */
@@ -0,0 +1,87 @@
+//
+//  MotionDetector.cpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "MotionDetector.hpp"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+static const int rowStep = 2;
+
+/// Sums absolute differences of row from previous row and copies row over it.
+/// @param skipAlpha Whether the 4th channel of 4-channel pixels is left out of the sum
+static uint64_t differenceAndKeep(const uint8_t *row, uint8_t *previousRow, int length, bool skipAlpha)
+{
+    uint64_t sum = 0;
+    int x = 0;
+    
+    // Alpha bytes are masked out of both rows before they are compared
+    uint32_t channelMask = skipAlpha ? 0x00FFFFFF : 0xFFFFFFFF;
+#if defined(__SSE2__)
+    __m128i sums = _mm_setzero_si128();
+    __m128i mask = _mm_set1_epi32((int)channelMask);
+    for (; x + 16 <= length; x += 16) {
+        __m128i pixels = _mm_loadu_si128((const __m128i *)(row + x));
+        __m128i previousPixels = _mm_loadu_si128((const __m128i *)(previousRow + x));
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_and_si128(pixels, mask), _mm_and_si128(previousPixels, mask)));
+        _mm_storeu_si128((__m128i *)(previousRow + x), pixels);
+    }
+    sum = (uint64_t)_mm_cvtsi128_si32(sums) + (uint64_t)_mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+#elif defined(__ARM_NEON)
+    // 16-bit lanes take 128 blocks of 16 pixels before they could overflow
+    uint32x4_t sums = vdupq_n_u32(0);
+    uint8x16_t mask = vreinterpretq_u8_u32(vdupq_n_u32(channelMask));
+    while (x + 16 <= length) {
+        uint16x8_t partialSums = vdupq_n_u16(0);
+        for (int block = 0; block < 128 && x + 16 <= length; block++, x += 16) {
+            uint8x16_t pixels = vld1q_u8(row + x);
+            partialSums = vpadalq_u8(partialSums, vandq_u8(vabdq_u8(pixels, vld1q_u8(previousRow + x)), mask));
+            vst1q_u8(previousRow + x, pixels);
+        }
+        sums = vpadalq_u16(sums, partialSums);
+    }
+    sum = (uint64_t)vgetq_lane_u32(sums, 0) + vgetq_lane_u32(sums, 1) + vgetq_lane_u32(sums, 2) + vgetq_lane_u32(sums, 3);
+#endif
+    for (; x < length; x++) {
+        if (!skipAlpha || (x & 3) != 3) {
+            sum += (uint64_t)std::abs(row[x] - previousRow[x]);
+        }
+        previousRow[x] = row[x];
+    }
+    return sum;
+}
+
+void MotionDetector::measure(const cv::Mat &frame, ColorSpace colorSpace, double energies[numberOfBands])
+{
+    bool comparable = previousFrame.size() == frame.size() && previousFrame.type() == frame.type();
+    if (!comparable) {
+        previousFrame.create(frame.size(), frame.type());
+    }
+    
+    int rowLength = frame.cols * (int)frame.elemSize();
+    
+    // Alpha is constant or undefined, so BGRA frames give the same energy as RGB
+    bool skipAlpha = colorSpace == ColorSpaceBGRA && frame.channels() == 4;
+    double channelsPerRow = skipAlpha ? frame.cols * 3.0 : rowLength;
+    for (int band = 0; band < numberOfBands; band++) {
+        int firstRow = band * frame.rows / numberOfBands;
+        int lastRow = (band + 1) * frame.rows / numberOfBands;
+        
+        // Only compared rows have to be kept
+        uint64_t sum = 0;
+        int numberOfRows = 0;
+        for (int y = firstRow; y < lastRow; y += rowStep, numberOfRows++) {
+            sum += differenceAndKeep(frame.ptr<uint8_t>(y), previousFrame.ptr<uint8_t>(y), rowLength, skipAlpha);
+        }
+        
+        energies[band] = comparable && numberOfRows > 0 ? (double)sum / (numberOfRows * channelsPerRow) : 0;
+    }
+}
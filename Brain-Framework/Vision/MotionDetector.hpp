@@ -0,0 +1,36 @@
+//
+//  MotionDetector.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef MotionDetector_hpp
+#define MotionDetector_hpp
+
+#include <iostream>
+#include <opencv2/opencv.hpp>
+
+#include "../Models/ColorSpace.h"
+
+/// Motion energy of eye frames, a cheap cue of motion instead of optical flow.
+/// Every other row of a frame is compared with the same row of the previous frame, which is kept in the same pass.
+class MotionDetector {
+    
+    cv::Mat previousFrame;
+    
+public:
+    
+    /// Number of horizontal bands, from top to bottom of frame
+    static const int numberOfBands = 3;
+    
+    /// Measures motion energy of frame and keeps it for the next one.
+    /// @param frame Eye frame with 8-bit channels
+    /// @param colorSpace Color space of frame, alpha of BGRA frames isn't compared
+    /// @param energies Mean absolute difference of color channels in every band in range [0, 255],
+    /// 0 for the first frame and when frame size changes
+    void measure(const cv::Mat &frame, ColorSpace colorSpace, double energies[numberOfBands]);
+};
+
+#endif /* MotionDetector_hpp */
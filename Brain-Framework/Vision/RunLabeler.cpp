@@ -0,0 +1,184 @@
+//
+//  RunLabeler.cpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "RunLabeler.hpp"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    static inline int countTrailingZeros(uint64_t word)
+    {
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return (int)index;
+    }
+#else
+    static inline int countTrailingZeros(uint64_t word)
+    {
+        return __builtin_ctzll(word);
+    }
+#endif
+
+void RunLabeler::pack(const cv::Mat &mask, uint64_t *bits, int wordsPerRow)
+{
+    for (int y = 0; y < mask.rows; y++) {
+        const uint8_t *row = mask.ptr<uint8_t>(y);
+        uint64_t *packedRow = bits + (size_t)y * wordsPerRow;
+        std::fill(packedRow, packedRow + wordsPerRow, 0);
+        
+        int x = 0;
+#if defined(__SSE2__)
+        // 16 pixels to 16 bits at once
+        const __m128i zero = _mm_setzero_si128();
+        for (; x + 16 <= mask.cols; x += 16) {
+            __m128i pixels = _mm_loadu_si128((const __m128i *)(row + x));
+            uint64_t set = (uint64_t)(~_mm_movemask_epi8(_mm_cmpeq_epi8(pixels, zero)) & 0xFFFF);
+            packedRow[x / 64] |= set << (x % 64);
+        }
+#endif
+        for (; x < mask.cols; x++) {
+            if (row[x]) {
+                packedRow[x / 64] |= (uint64_t)1 << (x % 64);
+            }
+        }
+    }
+}
+
+int RunLabeler::find(int run)
+{
+    while (parents[run] != run) {
+        parents[run] = parents[parents[run]];
+        run = parents[run];
+    }
+    return run;
+}
+
+void RunLabeler::join(int first, int second)
+{
+    first = find(first);
+    second = find(second);
+    
+    // Earlier run stays the root, so components keep order of their first pixel
+    if (first < second) {
+        parents[second] = first;
+    } else if (second < first) {
+        parents[first] = second;
+    }
+}
+
+Blob RunLabeler::largestBlob(const cv::Mat &mask)
+{
+    int wordsPerRow = (mask.cols + 63) / 64;
+    bits.resize((size_t)wordsPerRow * mask.rows);
+    pack(mask, bits.data(), wordsPerRow);
+    return largestBlob(bits.data(), wordsPerRow, mask.cols, mask.rows);
+}
+
+Blob RunLabeler::largestBlob(const uint64_t *packedBits, int wordsPerRow, int width, int height)
+{
+    runs.clear();
+    components_.clear();
+    
+    int previousRowBegin = 0;
+    int previousRowEnd = 0;
+    
+    for (int y = 0; y < height; y++) {
+        const uint64_t *row = packedBits + (size_t)y * wordsPerRow;
+        int rowBegin = (int)runs.size();
+        
+        // Runs of set bits, a run may continue over several words
+        bool inRun = false;
+        int runStart = 0;
+        for (int k = 0; k < wordsPerRow; k++) {
+            uint64_t word = row[k];
+            int position = 0;
+            while (position < 64) {
+                // Looking for the first clear bit inside a run and for the first set bit outside of it
+                uint64_t candidates = (inRun ? ~word : word) & (~(uint64_t)0 << position);
+                if (candidates == 0) {
+                    break;
+                }
+                position = countTrailingZeros(candidates);
+                if (inRun) {
+                    runs.push_back({ runStart, k * 64 + position, y });
+                } else {
+                    runStart = k * 64 + position;
+                }
+                inRun = !inRun;
+            }
+        }
+        if (inRun) {
+            runs.push_back({ runStart, width, y });
+        }
+        int rowEnd = (int)runs.size();
+        
+        if (parents.size() < runs.size()) {
+            parents.resize(runs.capacity());
+        }
+        for (int r = rowBegin; r < rowEnd; r++) {
+            parents[r] = r;
+        }
+        
+        // Runs touch if they overlap or meet diagonally
+        int i = previousRowBegin;
+        for (int j = rowBegin; j < rowEnd; j++) {
+            while (i < previousRowEnd && runs[i].end < runs[j].start) {
+                i++;
+            }
+            for (int k = i; k < previousRowEnd && runs[k].start <= runs[j].end; k++) {
+                join(k, j);
+            }
+        }
+        
+        previousRowBegin = rowBegin;
+        previousRowEnd = rowEnd;
+    }
+    
+    // Accumulate moments of runs into their components
+    componentIndices.assign(runs.size(), -1);
+    for (int r = 0; r < (int)runs.size(); r++) {
+        const Run &run = runs[r];
+        int root = find(r);
+        if (componentIndices[root] < 0) {
+            componentIndices[root] = (int)components_.size();
+            components_.push_back({ 0, 0, 0, run.start, run.row, run.end - 1, run.row });
+        }
+        Component &component = components_[componentIndices[root]];
+        int length = run.end - run.start;
+        component.area += length;
+        component.sumX += (int64_t)length * (run.start + run.end - 1) / 2;
+        component.sumY += (int64_t)length * run.row;
+        component.minX = std::min(component.minX, run.start);
+        component.maxX = std::max(component.maxX, run.end - 1);
+        component.maxY = run.row;
+    }
+    
+    Blob blob;
+    int largest = -1;
+    for (int c = 0; c < (int)components_.size(); c++) {
+        if (components_[c].area > blob.area) {
+            blob.area = components_[c].area;
+            largest = c;
+        }
+    }
+    
+    if (largest < 0) {
+        // Centroid of the whole mask, as for background label
+        blob.centroidX = (width - 1) / 2.0;
+        blob.centroidY = (height - 1) / 2.0;
+    } else {
+        const Component &component = components_[largest];
+        blob.centroidX = (double)component.sumX / component.area;
+        blob.centroidY = (double)component.sumY / component.area;
+        blob.bounds = cv::Rect(component.minX, component.minY, component.maxX - component.minX + 1, component.maxY - component.minY + 1);
+    }
+    return blob;
+}
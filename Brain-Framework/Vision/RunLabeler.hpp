@@ -0,0 +1,81 @@
+//
+//  RunLabeler.hpp
+//  Brain-Framework
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef RunLabeler_hpp
+#define RunLabeler_hpp
+
+#include <iostream>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "../Models/Blob.hpp"
+
+/// Labels 8-connected components of binary masks by runs instead of pixels.
+/// Mask rows are packed to bits, runs of set bits are found word by word and runs which touch runs of the previous row
+/// are joined with union-find. Work grows with the number of runs, not pixels, so sparse masks are cheap. Only area,
+/// first order moments and bounds of components are computed, there is no label image.
+/// Buffers are kept between calls and grow only when a mask has more rows or runs than any before.
+class RunLabeler {
+public:
+    
+    /// Connected component of a mask.
+    struct Component {
+        /// Number of pixels, zeroth moment
+        int area;
+        /// Sum of pixel columns, first moment in x
+        int64_t sumX;
+        /// Sum of pixel rows, first moment in y
+        int64_t sumY;
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+    };
+    
+private:
+    
+    struct Run {
+        int start;
+        int end;
+        int row;
+    };
+    
+    std::vector<uint64_t> bits;
+    std::vector<Run> runs;
+    std::vector<int> parents;
+    std::vector<int> componentIndices;
+    std::vector<Component> components_;
+    
+    int find(int run);
+    void join(int first, int second);
+    
+public:
+    
+    /// Packs mask rows to bits, bit `x % 64` of word `x / 64` is set for nonzero pixels.
+    /// @param mask Mask of type `CV_8UC1`
+    /// @param bits Packed rows, `wordsPerRow` words each
+    /// @param wordsPerRow Words per packed row, at least `(mask.cols + 63) / 64`
+    static void pack(const cv::Mat &mask, uint64_t *bits, int wordsPerRow);
+    
+    /// Labels mask and returns its largest component.
+    /// If mask has no nonzero pixels, returned blob has zero area and centroid of the whole mask.
+    /// @param mask Mask of type `CV_8UC1`
+    Blob largestBlob(const cv::Mat &mask);
+    
+    /// Labels packed mask and returns its largest component, ties are won by the component which starts first.
+    /// @param bits Packed rows, see `pack`, bits past `width` have to be zero
+    /// @param wordsPerRow Words per packed row
+    /// @param width Number of mask columns
+    /// @param height Number of mask rows
+    Blob largestBlob(const uint64_t *bits, int wordsPerRow, int width, int height);
+    
+    /// Components found by the last call of `largestBlob`, in order of their first pixel.
+    const std::vector<Component> &components() const { return components_; }
+};
+
+#endif /* RunLabeler_hpp */
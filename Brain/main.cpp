@@ -8,8 +8,13 @@
 
 #include <iostream>
 #include <fstream>
+#include <chrono>
 #include "../Brain-Framework/BrainWorker.hpp"
 #include "../Brain-Framework/AudioProcessing.cpp"
+#include "../Brain-Framework/Vision/ColorClassifier.hpp"
+#include "../Brain-Framework/Vision/BlobDetector.hpp"
+#include "../Brain-Framework/Vision/RunLabeler.hpp"
+#include "../Brain-Framework/Vision/MotionDetector.hpp"
 
 void testAudioProcessing() {
     std::vector<float> data = {1000, 2};
@@ -19,6 +24,176 @@ void testAudioProcessing() {
 //    calculateMaxAmpAndFreq(data, &maxAmp, &maxFreq);
 }
 
+/// Compares masks of vectorized color classification with scalar reference on random pixels.
+/// @return Number of mismatched pixels
+int testColorClassification() {
+    int mismatches = 0;
+    ColorSpace colorSpaces[] = {ColorSpaceRGB, ColorSpaceBGRA};
+    
+    for (ColorSpace colorSpace : colorSpaces) {
+        int bytesPerPixel = colorSpace == ColorSpaceBGRA ? 4 : 3;
+        for (int width = 1; width < 300; width += 7) {
+            std::vector<uint8_t> pixels(width * bytesPerPixel);
+            for (size_t i = 0; i < pixels.size(); i++) {
+                pixels[i] = rand() % 256;
+            }
+            
+            std::vector<uint8_t> masks[2][ColorClassifier::numberOfColors];
+            for (int k = 0; k < 2; k++) {
+                for (int color = 0; color < ColorClassifier::numberOfColors; color++) {
+                    masks[k][color].resize(width);
+                }
+            }
+            ColorClassifier::classifyRow(pixels.data(), width, colorSpace, masks[0][ColorRed].data(), masks[0][ColorGreen].data(), masks[0][ColorBlue].data());
+            ColorClassifier::classifyRowScalar(pixels.data(), width, colorSpace, masks[1][ColorRed].data(), masks[1][ColorGreen].data(), masks[1][ColorBlue].data());
+            
+            for (int color = 0; color < ColorClassifier::numberOfColors; color++) {
+                for (int j = 0; j < width; j++) {
+                    mismatches += masks[0][color][j] != masks[1][color][j];
+                }
+            }
+        }
+    }
+    std::cout << "Color classification mismatches: " << mismatches << std::endl;
+    return mismatches;
+}
+
+/// Compares classification of Bayer quads whose green samples are equal with classification of the same RGB pixels.
+/// @return Number of mismatched pixels
+int testBayerClassification() {
+    const int width = 256;
+    int mismatches = 0;
+    ColorSpace colorSpaces[] = {ColorSpaceBayerRGGB, ColorSpaceBayerBGGR};
+    
+    std::vector<uint8_t> pixels(width * 3);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = rand() % 256;
+    }
+    
+    for (ColorSpace colorSpace : colorSpaces) {
+        int redIndex = colorSpace == ColorSpaceBayerRGGB ? 0 : 3;
+        std::vector<uint8_t> quads(width * 4);
+        for (int j = 0; j < width; j++) {
+            quads[j * 4 + redIndex] = pixels[j * 3];
+            quads[j * 4 + 1] = pixels[j * 3 + 1];
+            quads[j * 4 + 2] = pixels[j * 3 + 1];
+            quads[j * 4 + 3 - redIndex] = pixels[j * 3 + 2];
+        }
+        
+        std::vector<uint8_t> masks[2][ColorClassifier::numberOfColors];
+        for (int k = 0; k < 2; k++) {
+            for (int color = 0; color < ColorClassifier::numberOfColors; color++) {
+                masks[k][color].resize(width);
+            }
+        }
+        ColorClassifier::classifyRow(quads.data(), width, colorSpace, masks[0][ColorRed].data(), masks[0][ColorGreen].data(), masks[0][ColorBlue].data());
+        ColorClassifier::classifyRow(pixels.data(), width, ColorSpaceRGB, masks[1][ColorRed].data(), masks[1][ColorGreen].data(), masks[1][ColorBlue].data());
+        
+        for (int color = 0; color < ColorClassifier::numberOfColors; color++) {
+            for (int j = 0; j < width; j++) {
+                mismatches += masks[0][color][j] != masks[1][color][j];
+            }
+        }
+    }
+    std::cout << "Bayer classification mismatches: " << mismatches << std::endl;
+    return mismatches;
+}
+
+/// Compares blobs found by tracking with full search on a moving blob next to a small static one.
+/// @return Number of frames where results differ
+int testBlobTracking() {
+    int mismatches = 0;
+    BlobDetector fullDetector;
+    BlobDetector trackingDetector;
+    cv::Mat mask(227, 227, CV_8UC1);
+    
+    for (int frame = 0; frame < 60; frame++) {
+        mask.setTo(0);
+        cv::circle(mask, cv::Point(30 + frame * 3, 100 + frame % 5), 20, cv::Scalar(1), cv::FILLED);
+        cv::circle(mask, cv::Point(200, 200), 5, cv::Scalar(1), cv::FILLED);
+        
+        Blob full = fullDetector.largestBlob(mask);
+        Blob tracked = trackingDetector.trackLargestBlob(mask);
+        
+        if (full.area != tracked.area || fabs(full.centroidX - tracked.centroidX) > 0.5 || fabs(full.centroidY - tracked.centroidY) > 0.5) {
+            mismatches++;
+        }
+    }
+    
+    // Window of previous blob holds only a small blob once masks get smaller
+    mask.setTo(0);
+    cv::circle(mask, cv::Point(100, 100), 20, cv::Scalar(1), cv::FILLED);
+    trackingDetector.trackLargestBlob(mask);
+    cv::Mat smallMask(113, 113, CV_8UC1, cv::Scalar(0));
+    cv::circle(smallMask, cv::Point(50, 50), 10, cv::Scalar(1), cv::FILLED);
+    cv::circle(smallMask, cv::Point(95, 95), 3, cv::Scalar(1), cv::FILLED);
+    mismatches += trackingDetector.trackLargestBlob(smallMask).area != fullDetector.largestBlob(smallMask).area;
+    
+    // Blob jumps out of its window, which keeps only a speck
+    mask.setTo(0);
+    cv::circle(mask, cv::Point(60, 60), 20, cv::Scalar(1), cv::FILLED);
+    cv::circle(mask, cv::Point(60, 90), 2, cv::Scalar(1), cv::FILLED);
+    trackingDetector.trackLargestBlob(mask);
+    mask.setTo(0);
+    cv::circle(mask, cv::Point(170, 170), 20, cv::Scalar(1), cv::FILLED);
+    cv::circle(mask, cv::Point(60, 90), 2, cv::Scalar(1), cv::FILLED);
+    mismatches += trackingDetector.trackLargestBlob(mask).area != fullDetector.largestBlob(mask).area;
+    
+    std::cout << "Blob tracking mismatches: " << mismatches << std::endl;
+    return mismatches;
+}
+
+/// Times run-based labeling against OpenCV on eye sized masks like the ones robot sees, a target blob, a smaller
+/// distractor and sparse noise, and checks that both find the same largest blob.
+/// @return Number of masks where results differ
+int benchmarkLabeling() {
+    const int numberOfMasks = 200;
+    const double noiseDensities[] = { 0.001, 0.01, 0.05 };
+    int mismatches = 0;
+    
+    RunLabeler labeler;
+    cv::Mat labels, stats, centroids;
+    cv::Mat mask(227, 227, CV_8UC1);
+    
+    for (double density : noiseDensities) {
+        double runMs = 0;
+        double openCVMs = 0;
+        
+        for (int i = 0; i < numberOfMasks; i++) {
+            mask.setTo(0);
+            cv::circle(mask, cv::Point(40 + i % 150, 110), 25, cv::Scalar(1), cv::FILLED);
+            cv::rectangle(mask, cv::Rect(180, 20, 15, 30), cv::Scalar(1), cv::FILLED);
+            for (int k = 0; k < density * mask.total(); k++) {
+                mask.at<uint8_t>(rand() % mask.rows, rand() % mask.cols) = 1;
+            }
+            
+            auto start = std::chrono::steady_clock::now();
+            Blob blob = labeler.largestBlob(mask);
+            auto middle = std::chrono::steady_clock::now();
+            int numberOfLabels = cv::connectedComponentsWithStats(mask, labels, stats, centroids, 8, CV_32S);
+            auto end = std::chrono::steady_clock::now();
+            
+            runMs += std::chrono::duration<double, std::milli>(middle - start).count();
+            openCVMs += std::chrono::duration<double, std::milli>(end - middle).count();
+            
+            int largest = 0;
+            int largestArea = 0;
+            for (int label = 1; label < numberOfLabels; label++) {
+                if (stats.at<int>(label, cv::CC_STAT_AREA) > largestArea) {
+                    largest = label;
+                    largestArea = stats.at<int>(label, cv::CC_STAT_AREA);
+                }
+            }
+            if (blob.area != largestArea || fabs(blob.centroidX - centroids.at<double>(largest, 0)) > 1e-6) {
+                mismatches++;
+            }
+        }
+        std::cout << "Labeling, noise " << density << ": runs " << runMs / numberOfMasks << " ms, OpenCV " << openCVMs / numberOfMasks << " ms" << std::endl;
+    }
+    std::cout << "Labeling mismatches: " << mismatches << std::endl;
+    return mismatches;
+}
+
 void testBrain() {
 //    int error = 0;
 //        Brain *brain = new Brain("/Data/Developing/BYB/rak-github/NeuroRobot/Matlab/Brains/Adan.mat", &error);
@@ -70,7 +245,183 @@ void testBrain() {
 //            while(true) {}
 //        }
 }
+
+/// Compares motion energy of a frame with change only in its top band with scalar reference on compared rows and
+/// times measurement of eye sized frames.
+/// @return Number of mismatched bands
+int testMotionEnergy() {
+    int mismatches = 0;
+    MotionDetector detector;
+    double energies[MotionDetector::numberOfBands];
+    cv::Mat first(227, 227, CV_8UC3);
+    cv::Mat second(227, 227, CV_8UC3);
+    for (size_t i = 0; i < first.total() * first.elemSize(); i++) {
+        first.data[i] = second.data[i] = rand() % 256;
+    }
+    for (int y = 10; y < 40; y++) {
+        for (int x = 0; x < 227 * 3; x++) {
+            second.ptr<uint8_t>(y)[x] = rand() % 256;
+        }
+    }
+    
+    detector.measure(first, ColorSpaceRGB, energies);
+    for (double energy : energies) {
+        mismatches += energy != 0;
+    }
+    
+    double sum = 0;
+    int numberOfRows = 0;
+    for (int y = 0; y < 227 / MotionDetector::numberOfBands; y += 2, numberOfRows++) {
+        for (int x = 0; x < 227 * 3; x++) {
+            sum += abs(first.ptr<uint8_t>(y)[x] - second.ptr<uint8_t>(y)[x]);
+        }
+    }
+    detector.measure(second, ColorSpaceRGB, energies);
+    mismatches += fabs(energies[0] - sum / (numberOfRows * 227 * 3)) > 1e-9;
+    mismatches += energies[1] != 0;
+    mismatches += energies[2] != 0;
+    
+    // The same pixels with alpha which changes between frames give the same energy as RGB
+    MotionDetector bgraDetector;
+    double bgraEnergies[MotionDetector::numberOfBands];
+    cv::Mat firstBGRA(227, 227, CV_8UC4);
+    cv::Mat secondBGRA(227, 227, CV_8UC4);
+    for (size_t i = 0; i < first.total(); i++) {
+        for (int c = 0; c < 3; c++) {
+            firstBGRA.data[i * 4 + c] = first.data[i * 3 + c];
+            secondBGRA.data[i * 4 + c] = second.data[i * 3 + c];
+        }
+        firstBGRA.data[i * 4 + 3] = rand() % 256;
+        secondBGRA.data[i * 4 + 3] = rand() % 256;
+    }
+    bgraDetector.measure(firstBGRA, ColorSpaceBGRA, bgraEnergies);
+    bgraDetector.measure(secondBGRA, ColorSpaceBGRA, bgraEnergies);
+    for (int band = 0; band < MotionDetector::numberOfBands; band++) {
+        mismatches += fabs(bgraEnergies[band] - energies[band]) > 1e-9;
+    }
+    
+    const int numberOfFrames = 1000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numberOfFrames; i++) {
+        detector.measure(i % 2 ? first : second, ColorSpaceRGB, energies);
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Motion energy: " << ms / numberOfFrames << " ms per eye, mismatches: " << mismatches << std::endl;
+    return mismatches;
+}
+
+/// Checks that governor lowers quality one level at a time under sustained overload, ignores a single slow loop
+/// and recovers to full quality after load drops.
+/// @return Number of failed checks
+int testQualityGovernor() {
+    int failures = 0;
+    QualityGovernor governor;
+    
+    // Short spike is smoothed away
+    for (int i = 0; i < 50; i++) {
+        failures += governor.update(0.3) != 0;
+    }
+    failures += governor.update(2.0) != 0;
+    for (int i = 0; i < 50; i++) {
+        failures += governor.update(0.3) != 0;
+    }
+    
+    // Level changes at most once per hold period until the cheapest level
+    int level = 0;
+    int loopsSinceChange = 100;
+    for (int i = 0; i < 200; i++, loopsSinceChange++) {
+        int newLevel = governor.update(1.0);
+        if (newLevel != level) {
+            failures += newLevel != level + 1 || loopsSinceChange < 9;
+            level = newLevel;
+            loopsSinceChange = 0;
+        }
+    }
+    failures += level != QualityGovernor::numberOfLevels - 1;
+    
+    // Recovery is slower than degradation
+    int numberOfLoops = 0;
+    while (level > 0 && numberOfLoops < 1000) {
+        int newLevel = governor.update(0.1);
+        failures += newLevel > level;
+        level = newLevel;
+        numberOfLoops++;
+    }
+    failures += level != 0 || numberOfLoops < 30 * (QualityGovernor::numberOfLevels - 1);
+    
+    governor.update(1.0);
+    governor.reset();
+    failures += governor.update(0.9) != 0;
+    
+    std::cout << "Quality governor failures: " << failures << std::endl;
+    return failures;
+}
+
+/// Counts frames which vision gave back.
+static int releasedFrames = 0;
+
+static void countReleasedFrame(void *) {
+    releasedFrames++;
+}
+
+/// Compares scores of a padded NV12 frame, whose chroma plane is a separate buffer, with scores of its packed copy.
+/// The same planes are submitted as I420 with chroma pixel stride 2 as well.
+/// @return Number of mismatched values and failed checks
+int testVideoPlanes() {
+    const int width = 320;
+    const int height = 240;
+    const size_t lumaBytesPerRow = width + 64;
+    const size_t chromaBytesPerRow = width + 32;
+    int mismatches = 0;
+    
+    // Red disk on gray background in full range BT.601, padding differs from both
+    std::vector<uint8_t> packed(width * height * 3 / 2);
+    std::vector<uint8_t> luma(lumaBytesPerRow * height, 0);
+    std::vector<uint8_t> chroma(chromaBytesPerRow * height / 2, 0);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            bool red = (x - 100) * (x - 100) + (y - 120) * (y - 120) < 50 * 50;
+            packed[y * width + x] = luma[y * lumaBytesPerRow + x] = red ? 76 : 128;
+            if (y % 2 == 0 && x % 2 == 0) {
+                packed[width * height + y / 2 * width + x] = chroma[y / 2 * chromaBytesPerRow + x] = red ? 85 : 128;
+                packed[width * height + y / 2 * width + x + 1] = chroma[y / 2 * chromaBytesPerRow + x + 1] = red ? 255 : 128;
+            }
+        }
+    }
+    
+    const uint8_t *planes[] = {luma.data(), chroma.data(), chroma.data() + 1};
+    size_t bytesPerRow[] = {lumaBytesPerRow, chromaBytesPerRow, chromaBytesPerRow};
+    std::vector<std::vector<double>> outputs[3];
+    for (int k = 0; k < 3; k++) {
+        BrainWorker worker;
+        worker.setVideoSize(width, height);
+        worker.colorSpace = ColorSpaceNV12;
+        if (k == 0) {
+            worker.setVideo(packed.data());
+        } else if (k == 1) {
+            mismatches += worker.submitVideoPlanes(planes, bytesPerRow, 2, 2, ColorSpaceNV12, countReleasedFrame, NULL) != 0;
+        } else {
+            mismatches += worker.submitVideoPlanes(planes, bytesPerRow, 3, 2, ColorSpaceI420, countReleasedFrame, NULL) != 0;
+        }
+        worker.processVisualInput();
+        outputs[k] = worker.getVisionOutput();
+    }
+    
+    for (int k = 1; k < 3; k++) {
+        mismatches += outputs[k] != outputs[0];
+    }
+    mismatches += outputs[0].empty() || outputs[0][ColorRed * 2][0] == 0;
+    mismatches += releasedFrames != 2;
+    
+    std::cout << "Video planes mismatches: " << mismatches << std::endl;
+    return mismatches;
+}
+
 int main(int argc, const char * argv[]) {
     testAudioProcessing();
+    if (testColorClassification() != 0 || testBayerClassification() != 0 || testBlobTracking() != 0 || benchmarkLabeling() != 0 || testMotionEnergy() != 0
+        || testQualityGovernor() != 0 || testVideoPlanes() != 0) {
+        return 1;
+    }
     return 0;
 }
@@ -0,0 +1,123 @@
+//
+//  main.cpp
+//  brainc
+//
+//  Created by Backyard Brains on 19/10/2026.
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+//  Compiles a brain file into a specialized simulation kernel.
+//
+//  usage: brainc <brain.mat> [-o <kernel.cpp>] [-c <cacheDirectory>] [-b <numberOfMs>]
+//      -o  writes emitted kernel source
+//      -c  compiles kernel into cache directory (skipped if already cached) and prints library path
+//      -b  runs compiled kernel for given number of simulated ms and reports speed relative to real time
+//
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include "../Brain-Framework/Models/Brain.hpp"
+#include "../Brain-Framework/Compiler/BrainCompiler.hpp"
+
+static const int msPerStep = 125;
+static const int nStepsPerLoop = 100;
+
+int benchmark(BrainCompiler &compiler, Brain &brain, long numberOfMs)
+{
+    int numberOfNeurons = (int)brain.neurons.size();
+    
+    std::vector<double> v(numberOfNeurons);
+    std::vector<double> u(numberOfNeurons);
+    std::vector<double> sensoryI(numberOfNeurons, 0);
+    std::vector<double> noise(numberOfNeurons * msPerStep);
+    std::vector<double> iStep(numberOfNeurons * msPerStep);
+    std::vector<uint8_t> spikes(numberOfNeurons * msPerStep);
+    
+    for (int i = 0; i < numberOfNeurons; i++) {
+        v[i] = brain.neurons[i].v;
+        u[i] = brain.neurons[i].u;
+    }
+    
+    std::mt19937 gen{ 0 };
+    std::normal_distribution<double> distribution(0.0, 1.0);
+    for (auto & value : noise) {
+        value = 5 * distribution(gen);
+    }
+    
+    long numberOfSpikes = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (long ms = 0; ms < numberOfMs; ms += msPerStep) {
+        std::fill(spikes.begin(), spikes.end(), 0);
+        compiler.getKernel()(v.data(), u.data(), sensoryI.data(), noise.data(), iStep.data(), spikes.data(), msPerStep);
+        for (auto spike : spikes) {
+            numberOfSpikes += spike;
+        }
+    }
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    
+    std::cout << "simulated " << numberOfMs << " ms in " << elapsedMs << " ms (" << numberOfMs / elapsedMs << "x real time), "
+              << numberOfSpikes << " spikes" << std::endl;
+    return 0;
+}
+
+int main(int argc, const char * argv[]) {
+    if (argc < 2) {
+        std::cout << "usage: brainc <brain.mat> [-o <kernel.cpp>] [-c <cacheDirectory>] [-b <numberOfMs>]" << std::endl;
+        return 1;
+    }
+    
+    std::string outputPath;
+    std::string cacheDirectory;
+    long numberOfMs = 0;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-o") == 0) {
+            outputPath = argv[i + 1];
+        } else if (strcmp(argv[i], "-c") == 0) {
+            cacheDirectory = argv[i + 1];
+        } else if (strcmp(argv[i], "-b") == 0) {
+            numberOfMs = atol(argv[i + 1]);
+        }
+    }
+    
+    Brain brain;
+    int error = brain.load(argv[1], msPerStep, nStepsPerLoop);
+    if (error != 0) {
+        std::cout << "loading brain failed: " << error << std::endl;
+        return error;
+    }
+    
+    std::string source = BrainCompiler::emit(brain);
+    
+    if (!outputPath.empty()) {
+        std::ofstream(outputPath) << source;
+    }
+    
+    if (cacheDirectory.empty()) {
+        if (outputPath.empty()) {
+            std::cout << source;
+        }
+        return 0;
+    }
+    
+    std::string libraryPath;
+    error = BrainCompiler::compile(source, cacheDirectory, libraryPath);
+    if (error != 0) {
+        std::cout << "compiling brain failed: " << error << std::endl;
+        return error;
+    }
+    std::cout << libraryPath << std::endl;
+    
+    if (numberOfMs > 0) {
+        BrainCompiler compiler;
+        error = compiler.load(libraryPath, (int)brain.neurons.size());
+        if (error != 0) {
+            std::cout << "loading compiled brain failed: " << error << std::endl;
+            return error;
+        }
+        return benchmark(compiler, brain, numberOfMs);
+    }
+    
+    return 0;
+}